@@ -45,6 +45,8 @@ extern "C" {
 
 typedef struct IAMF_StreamInfo {
   uint32_t max_frame_size;
+  uint32_t pipeline_latency;  // output samples delayed by pipelined decoding.
+  uint32_t max_output_size;   // output samples of a decoding call at most.
 } IAMF_StreamInfo;
 
 /**@}*/
@@ -93,12 +95,34 @@ int IAMF_decoder_configure(IAMF_DecoderHandle handle, const uint8_t *data,
  *                               if is null, it means the data is a complete
  *                               access unit which includes all OBUs of
  *                               substream frames and parameters.
- * @param     [out] pcm : output signal.
+ * @param     [out] pcm : output signal, which holds max_output_size samples
+ *                        per channel of @ref IAMF_StreamInfo.
  * @return    the number of decoded samples or @ref IAErrCode.
  */
 int IAMF_decoder_decode(IAMF_DecoderHandle handle, const uint8_t *data,
                         int32_t size, uint32_t *rsize, void *pcm);
 
+/**
+ * @brief     Decode bitstream to float samples, the samples are neither
+ *            clamped nor converted to the bit depth of
+ *            @ref IAMF_decoder_set_bit_depth.
+ * @param     [in] handle : iamf decoder handle.
+ * @param     [in] data : the OBUs in bitstream.
+ *                        if is null, the output is delay signal.
+ * @param     [in] size : the size in bytes of bitstream.
+ * @param     [in & out] rsize : the size in bytes of bitstream that has been
+ *                               consumed.
+ * @param     [out] pcm : output signal. one buffer per output channel, or
+ *                        only pcm[0] when interleaved, of max_output_size
+ *                        samples per channel of @ref IAMF_StreamInfo.
+ * @param     [in] interleaved : 1 indicates the samples are interleaved by
+ *                               the output channels, 0 indicates planar.
+ * @return    the number of decoded samples or @ref IAErrCode.
+ */
+int IAMF_decoder_decode_float(IAMF_DecoderHandle handle, const uint8_t *data,
+                              int32_t size, uint32_t *rsize, float **pcm,
+                              uint32_t interleaved);
+
 /**
  * @brief     Set a mix presentation label.
  * @param     [in] handle : iamf decoder handle.
@@ -194,6 +218,34 @@ float IAMF_decoder_peak_limiter_get_threshold(IAMF_DecoderHandle handle);
  */
 int IAMF_decoder_set_sampling_rate(IAMF_DecoderHandle handle, uint32_t rate);
 
+/**
+ * @brief     Set the number of threads used to decode audio elements in
+ *            parallel. The decoding is done in the calling thread by default,
+ *            the output is the same whatever the number of threads is.
+ * @param     [in] handle : iamf decoder handle.
+ * @param     [in] threads : number of threads including the calling thread,
+ *            0 or 1 indicates no worker thread, which is rejected with
+ *            IAMF_ERR_INVALID_STATE when pipelined decoding is enabled.
+ * @return    @ref IAErrCode.
+ */
+int IAMF_decoder_set_threads(IAMF_DecoderHandle handle, uint32_t threads);
+
+/**
+ * @brief     Enable pipelined decoding. The post processing of the mixed frame
+ *            runs on another thread while the next frame is decoded, so the
+ *            output is delayed by one frame, see pipeline_latency in
+ *            @ref IAMF_StreamInfo. The pending frame is output when flushing
+ *            or before the decoder needs to be reconfigured. When flushing,
+ *            the pending frame and the last frame are output by the same
+ *            call, so pcm must hold max_output_size samples per channel of
+ *            @ref IAMF_StreamInfo instead of max_frame_size. Opens a 2-thread
+ *            pool if no thread is set, and must be set before configuration.
+ * @param     [in] handle : iamf decoder handle.
+ * @param     [in] enable : 1 indicates enabled, and 0 indicates disable.
+ * @return    @ref IAErrCode.
+ */
+int IAMF_decoder_pipeline_enable(IAMF_DecoderHandle handle, uint32_t enable);
+
 /**
  * @brief     Get stream info.Must be used after decoder configuration.
  * @param     [in] handle : iamf decoder handle.
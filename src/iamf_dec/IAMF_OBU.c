@@ -74,60 +74,94 @@ static void iamf_parameter_free(IAMF_Parameter *obj);
 
 static IAMF_Frame *iamf_frame_new(IAMF_OBU *obu);
 
-static void iamf_parameter_recon_gain_segment_free(ReconGainSegment *seg);
+/**
+ * Reads a leb128 value of 8 bytes at most in the same way as bs_getAleb128,
+ * returns the number of bytes consumed.
+ * */
+static inline uint32_t iamf_obu_leb128(const uint8_t *p, uint32_t size,
+                                       uint64_t *v) {
+  uint64_t ret;
+  uint32_t i;
+
+  if (!size) {
+    *v = 0;
+    return 0;
+  }
+
+  if (!(p[0] & 0x80)) {
+    *v = p[0];
+    return 1;
+  }
+
+  ret = p[0] & 0x7f;
+  for (i = 1; i < 8 && i < size; ++i) {
+    ret |= ((uint64_t)p[i] & 0x7f) << (i * 7);
+    if (!(p[i] & 0x80)) break;
+  }
+  *v = ret;
+  return i + 1;
+}
 
 uint32_t IAMF_OBU_split(const uint8_t *data, uint32_t size, IAMF_OBU *obu) {
-  BitStream b;
   uint64_t ret = 0;
+  uint32_t pos;
+  uint8_t h;
 
   if (size < IAMF_OBU_MIN_SIZE) {
     return 0;
   }
 
-  bs(&b, data, size);
-
-  memset(obu, 0, sizeof(IAMF_OBU));
-  obu->type = bs_get32b(&b, 5);
-  obu->redundant = bs_get32b(&b, 1);
-  obu->trimming = bs_get32b(&b, 1);
-  obu->extension = bs_get32b(&b, 1);
+  h = data[0];
+  obu->type = h >> 3;
+  obu->redundant = (h >> 2) & 1;
+  obu->trimming = (h >> 1) & 1;
+  obu->extension = h & 1;
 
-  ret = bs_getAleb128(&b);
+  pos = 1 + iamf_obu_leb128(data + 1, size - 1, &ret);
 
-  if (ret == UINT64_MAX || ret + bs_tell(&b) > size) return 0;
+  if (ret == UINT64_MAX || ret + pos > size) return 0;
 
   ia_logt("===============================================");
   ia_logt(
       "obu header : %s (%d) type, redundant %d, trimming %d, extension %d, "
       "payload size %" PRIu64 ", obu size %" PRIu64 " vs size %u",
       IAMF_OBU_type_string(obu->type), obu->type, obu->redundant, obu->trimming,
-      obu->extension, ret, bs_tell(&b) + ret, size);
+      obu->extension, ret, pos + ret, size);
 
   if (obu->redundant) {
     ia_logd("%s OBU redundant.", IAMF_OBU_type_string(obu->type));
   }
 
   obu->data = (uint8_t *)data;
-  obu->size = bs_tell(&b) + (uint32_t)ret;
+  obu->size = pos + (uint32_t)ret;
+#if SUPPORT_VERIFIER
   obu_dump(data, obu->size, obu->type);
+#endif
 
+  obu->trim_start = obu->trim_end = 0;
   if (obu->trimming) {
-    obu->trim_end = bs_getAleb128(&b);    // num_samples_to_trim_at_end;
-    obu->trim_start = bs_getAleb128(&b);  // num_samples_to_trim_at_start;
+    // num_samples_to_trim_at_end and num_samples_to_trim_at_start.
+    pos += iamf_obu_leb128(data + pos, size > pos ? size - pos : 0,
+                           &obu->trim_end);
+    pos += iamf_obu_leb128(data + pos, size > pos ? size - pos : 0,
+                           &obu->trim_start);
     ia_logt("trim samples at start %" PRIu64 ", at end %" PRIu64,
             obu->trim_start, obu->trim_end);
   }
 
+  obu->ext_header = 0;
+  obu->ext_size = 0;
   if (obu->extension) {
-    obu->ext_size = bs_getAleb128(&b);  // extension_header_size;
-    obu->ext_header = (uint8_t *)obu->data + bs_tell(&b);
-    ia_logt("obu extension header at %u, size %" PRIu64, bs_tell(&b),
-            obu->ext_size);
-    bs_skipABytes(&b, obu->ext_size);  // skip extension header
+    // extension_header_size.
+    pos += iamf_obu_leb128(data + pos, size > pos ? size - pos : 0,
+                           &obu->ext_size);
+    obu->ext_header = (uint8_t *)obu->data + pos;
+    ia_logt("obu extension header at %u, size %" PRIu64, pos, obu->ext_size);
+    pos += obu->ext_size;  // skip extension header
   }
 
-  ia_logt("obu payload start at %u", bs_tell(&b));
-  obu->payload = (uint8_t *)data + bs_tell(&b);
+  ia_logt("obu payload start at %u", pos);
+  obu->payload = (uint8_t *)data + pos;
 
 #if SUPPORT_VERIFIER
   if (obu->type == IAMF_OBU_TEMPORAL_DELIMITER)
@@ -240,13 +274,64 @@ void IAMF_object_free(IAMF_Object *obj) {
   }
 }
 
-void IAMF_parameter_segment_free(ParameterSegment *seg) {
-  if (seg) {
-    if (seg->type == IAMF_PARAMETER_TYPE_RECON_GAIN) {
-      iamf_parameter_recon_gain_segment_free((ReconGainSegment *)seg);
-    } else
-      free(seg);
+void IAMF_parameter_segment_free(ParameterSegment *seg) { IAMF_FREE(seg); }
+
+void IAMF_parameter_segment_release(ParameterSegmentPool *pool,
+                                    ParameterSegment *seg) {
+  if (!seg) return;
+  if (pool && pool->count == pool->size) {
+    int size = pool->size ? pool->size * 2 : 8;
+    ParameterSegment **items =
+        IAMF_REALLOC(ParameterSegment *, pool->items, size);
+    if (items) {
+      pool->items = items;
+      pool->size = size;
+    }
+  }
+
+  if (pool && pool->count < pool->size)
+    pool->items[pool->count++] = seg;
+  else
+    free(seg);
+}
+
+void IAMF_parameter_segment_pool_clear(ParameterSegmentPool *pool) {
+  for (int i = 0; i < pool->count; ++i) free(pool->items[i]);
+  IAMF_FREE(pool->items);
+  memset(pool, 0, sizeof(ParameterSegmentPool));
+}
+
+/**
+ * Gets a zeroed segment from the pool, or allocates it if the pool is empty.
+ * The segments in the pool of a parameter have the same type and layer count.
+ * */
+ParameterSegment *IAMF_parameter_segment_new(ParameterSegmentPool *pool,
+                                             uint64_t type, int nb_layers) {
+  ParameterSegment *seg;
+  size_t size;
+
+  if (type == IAMF_PARAMETER_TYPE_MIX_GAIN)
+    size = sizeof(MixGainSegment);
+  else if (type == IAMF_PARAMETER_TYPE_DEMIXING)
+    size = sizeof(DemixingSegment);
+  else
+    size = sizeof(ReconGainSegment) + sizeof(ReconGain) * nb_layers;
+
+  if (pool && pool->count > 0) {
+    seg = pool->items[--pool->count];
+    memset(seg, 0, size);
+  } else {
+    seg = (ParameterSegment *)IAMF_MALLOCZ(uint8_t, size);
+    if (!seg) return 0;
   }
+
+  seg->type = type;
+  if (type == IAMF_PARAMETER_TYPE_RECON_GAIN) {
+    ReconGainSegment *rg = (ReconGainSegment *)seg;
+    rg->list.count = nb_layers;
+    rg->list.recon = (ReconGain *)(rg + 1);
+  }
+  return seg;
 }
 
 uint32_t iamf_obu_get_payload_size(IAMF_OBU *obu) {
@@ -987,24 +1072,24 @@ static uint64_t iamf_parameter_get_segment_interval(uint64_t duration,
   return const_interval < duration ? const_interval : duration;
 }
 
-IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
-                                   IAMF_ParameterParam *objParam) {
-  IAMF_Parameter *para = 0;
+/**
+ * Parses the parameter block obu into para, the segments array of para is
+ * kept for the next parameter block.
+ * */
+int IAMF_parameter_init(IAMF_Parameter *para, IAMF_OBU *obu,
+                        IAMF_ParameterParam *objParam) {
+  ParameterSegmentPool *pool = objParam ? objParam->pool : 0;
   ParameterSegment *seg;
   BitStream b;
   uint64_t interval = 0;
   uint64_t intervals;
   uint64_t segment_interval;
 
-  para = IAMF_MALLOCZ(IAMF_Parameter, 1);
-  if (!para) {
-    ia_loge("fail to allocate memory for Parameter Object.");
-    goto parameter_fail;
-  }
-
+  IAMF_parameter_reset(para, 0);
   bs(&b, obu->payload, iamf_obu_get_payload_size(obu));
 
   para->obj.type = IAMF_OBU_PARAMETER_BLOCK;
+  para->obj.flags = obu->redundant ? IAMF_OBU_FLAG_REDUNDANT : 0;
   para->id = bs_getAleb128(&b);
 
   if (!objParam || !objParam->param_base) {
@@ -1043,11 +1128,18 @@ IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
           para->id, para->duration, para->nb_segments,
           para->constant_segment_interval, para->type);
 
-  para->segments = IAMF_MALLOCZ(ParameterSegment *, para->nb_segments);
-  if (!para->segments) {
-    ia_loge("fail to allocate segments for Parameter Object.");
-    goto parameter_fail;
+  if (para->nb_segments > para->size) {
+    ParameterSegment **segments =
+        IAMF_REALLOC(ParameterSegment *, para->segments, para->nb_segments);
+    if (!segments) {
+      ia_loge("fail to allocate segments for Parameter Object.");
+      para->nb_segments = 0;
+      goto parameter_fail;
+    }
+    para->segments = segments;
+    para->size = para->nb_segments;
   }
+  memset(para->segments, 0, sizeof(ParameterSegment *) * para->nb_segments);
 
   for (int i = 0; i < para->nb_segments; ++i) {
     if (!objParam->param_base->mode) {
@@ -1068,14 +1160,14 @@ IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
 
     switch (para->type) {
       case IAMF_PARAMETER_TYPE_MIX_GAIN: {
-        MixGainSegment *mg = IAMF_MALLOCZ(MixGainSegment, 1);
+        MixGainSegment *mg = (MixGainSegment *)IAMF_parameter_segment_new(
+            pool, IAMF_PARAMETER_TYPE_MIX_GAIN, 0);
         float gain_db, gain1_db, gain2_db;
         if (!mg) {
           ia_loge("fail to allocate mix gain segment for Parameter Object.");
           goto parameter_fail;
         }
 
-        mg->seg.type = IAMF_PARAMETER_TYPE_MIX_GAIN;
         seg = (ParameterSegment *)mg;
         para->segments[i] = seg;
         seg->segment_interval = segment_interval;
@@ -1123,12 +1215,12 @@ IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
         }
       } break;
       case IAMF_PARAMETER_TYPE_DEMIXING: {
-        DemixingSegment *mode = IAMF_MALLOC(DemixingSegment, 1);
+        DemixingSegment *mode = (DemixingSegment *)IAMF_parameter_segment_new(
+            pool, IAMF_PARAMETER_TYPE_DEMIXING, 0);
         if (!mode) {
           ia_loge("fail to allocate demixing segment for Parameter Object.");
           goto parameter_fail;
         }
-        mode->seg.type = IAMF_PARAMETER_TYPE_DEMIXING;
         seg = (ParameterSegment *)mode;
         para->segments[i] = seg;
         seg->segment_interval = segment_interval;
@@ -1146,39 +1238,30 @@ IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
           ReconGainSegment *recon_gain;
           int channels = 0;
 
-          recon_gain = IAMF_MALLOCZ(ReconGainSegment, 1);
+          recon_gain = (ReconGainSegment *)IAMF_parameter_segment_new(
+              pool, IAMF_PARAMETER_TYPE_RECON_GAIN, count);
           if (!recon_gain) {
             ia_loge(
                 "fail to allocate Recon gain segment for Parameter Object.");
             goto parameter_fail;
           }
 
-          recon_gain->seg.type = IAMF_PARAMETER_TYPE_RECON_GAIN;
           list = &recon_gain->list;
 
           seg = (ParameterSegment *)recon_gain;
           para->segments[i] = seg;
           seg->segment_interval = segment_interval;
           ia_logd("there are %d recon gain info, list is %p", count, list);
-          list->count = count;
-          recon = IAMF_MALLOCZ(ReconGain, list->count);
-          list->recon = recon;
-          if (!recon) {
-            ia_loge("fail to allocate Recon gain for Parameter Object.");
-            goto parameter_fail;
-          }
+          recon = list->recon;
           for (int k = 0; k < list->count; ++k) {
             if (~objParam->recon_gain_present_flags & RSHIFT(k)) continue;
             recon[k].flags = bs_getAleb128(&b);
             channels = bit1_count(recon[k].flags);
+            if (channels > IA_CH_RE_COUNT) {
+              ia_loge("Invalid recon gain flags 0x%x.", recon[k].flags);
+              goto parameter_fail;
+            }
             if (channels > 0) {
-              recon[k].recon_gain = IAMF_MALLOCZ(uint8_t, channels);
-              recon[k].recon_gain_f = IAMF_MALLOCZ(float, channels);
-              if (!recon[k].recon_gain || !recon[k].recon_gain_f) {
-                ia_loge(
-                    "fail to allocate recon gain value for Parameter Object.");
-                goto parameter_fail;
-              }
               bs_read(&b, recon[k].recon_gain, channels);
               ia_logd("recon gain info %d : flags 0x%x, channels %d", k,
                       recon[k].flags, channels);
@@ -1207,59 +1290,80 @@ IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
   vlog_obu(IAMF_OBU_PARAMETER_BLOCK, para, 0, 0);
 #endif
 
-  return para;
+  return IAMF_OK;
 
 parameter_fail:
-  if (para) iamf_parameter_free(para);
-  return 0;
+  IAMF_parameter_reset(para, 0);
+  return IAMF_ERR_BAD_ARG;
 }
 
-void iamf_parameter_free(IAMF_Parameter *obj) {
-  if (obj->segments) {
-    for (int i = 0; i < obj->nb_segments; ++i) {
-      IAMF_parameter_segment_free(obj->segments[i]);
-    }
-    free(obj->segments);
+/* releases the segments which are not taken away from para into pool. */
+void IAMF_parameter_reset(IAMF_Parameter *para, ParameterSegmentPool *pool) {
+  for (int i = 0; i < para->nb_segments; ++i) {
+    IAMF_parameter_segment_release(pool, para->segments[i]);
+    para->segments[i] = 0;
   }
-  free(obj);
+  para->nb_segments = 0;
 }
 
-IAMF_Frame *iamf_frame_new(IAMF_OBU *obu) {
-  IAMF_Frame *pkt = 0;
-  BitStream b;
+IAMF_Parameter *iamf_parameter_new(IAMF_OBU *obu,
+                                   IAMF_ParameterParam *objParam) {
+  IAMF_Parameter *para = IAMF_MALLOCZ(IAMF_Parameter, 1);
 
-  pkt = IAMF_MALLOCZ(IAMF_Frame, 1);
-  if (!pkt) {
-    ia_loge("fail to allocate memory for Audio Frame Object.");
+  if (!para) {
+    ia_loge("fail to allocate memory for Parameter Object.");
+    return 0;
+  }
+
+  if (IAMF_parameter_init(para, obu, objParam) != IAMF_OK) {
+    iamf_parameter_free(para);
     return 0;
   }
+  return para;
+}
+
+void iamf_parameter_free(IAMF_Parameter *obj) {
+  IAMF_parameter_reset(obj, 0);
+  IAMF_FREE(obj->segments);
+  free(obj);
+}
+
+/* parses the audio frame obu into a view of its payload. */
+int IAMF_frame_init(IAMF_Frame *frame, IAMF_OBU *obu) {
+  BitStream b;
+
+  if (obu->type < IAMF_OBU_AUDIO_FRAME || obu->type > IAMF_OBU_AUDIO_FRAME_ID17)
+    return IAMF_ERR_BAD_ARG;
 
   bs(&b, obu->payload, iamf_obu_get_payload_size(obu));
 
-  pkt->obj.type = obu->type;
+  frame->obj.type = obu->type;
+  frame->obj.flags = obu->redundant ? IAMF_OBU_FLAG_REDUNDANT : 0;
   if (obu->type == IAMF_OBU_AUDIO_FRAME) {
-    pkt->id = bs_getAleb128(&b);
+    frame->id = bs_getAleb128(&b);
   } else {
-    pkt->id = obu->type - IAMF_OBU_AUDIO_FRAME_ID0;
+    frame->id = obu->type - IAMF_OBU_AUDIO_FRAME_ID0;
   }
-  pkt->trim_start = obu->trim_start;
-  pkt->trim_end = obu->trim_end;
-  pkt->data = obu->payload + bs_tell(&b);
-  pkt->size = iamf_obu_get_payload_size(obu) - bs_tell(&b);
+  frame->trim_start = obu->trim_start;
+  frame->trim_end = obu->trim_end;
+  frame->data = obu->payload + bs_tell(&b);
+  frame->size = iamf_obu_get_payload_size(obu) - bs_tell(&b);
 
 #if SUPPORT_VERIFIER
-  vlog_obu(IAMF_OBU_AUDIO_FRAME, pkt, obu->trim_start, obu->trim_end);
+  vlog_obu(IAMF_OBU_AUDIO_FRAME, frame, obu->trim_start, obu->trim_end);
 #endif
-  return pkt;
+  return IAMF_OK;
 }
 
-void iamf_parameter_recon_gain_segment_free(ReconGainSegment *seg) {
-  if (seg->list.recon) {
-    for (int i = 0; i < seg->list.count; ++i) {
-      IAMF_FREE(seg->list.recon[i].recon_gain);
-      IAMF_FREE(seg->list.recon[i].recon_gain_f);
-    }
-    free(seg->list.recon);
+IAMF_Frame *iamf_frame_new(IAMF_OBU *obu) {
+  IAMF_Frame *pkt = 0;
+
+  pkt = IAMF_MALLOCZ(IAMF_Frame, 1);
+  if (!pkt) {
+    ia_loge("fail to allocate memory for Audio Frame Object.");
+    return 0;
   }
-  free(seg);
+
+  IAMF_frame_init(pkt, obu);
+  return pkt;
 }
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdint.h>
 
 #include "IAMF_defines.h"
+#include "IAMF_types.h"
 
 #define IAMF_OBJ(a) ((IAMF_Object *)(a))
 #define IAMF_ELEMENT(a) ((IAMF_Element *)(a))
@@ -116,11 +117,14 @@ typedef struct IAMF_ObjectParameter {
 typedef struct ParameterBase ParameterBase;
 #define PARAMETER_BASE(a) ((ParameterBase *)(a))
 
+typedef struct ParameterSegmentPool ParameterSegmentPool;
+
 typedef struct IAMF_ParameterParam {
   IAMF_ObjectParameter base;
   ParameterBase *param_base;
   int nb_layers;
   uint32_t recon_gain_present_flags;
+  ParameterSegmentPool *pool;
 } IAMF_ParameterParam;
 
 /**
@@ -322,6 +326,7 @@ typedef struct IAMF_Parameter {
   uint64_t type;
 
   ParameterSegment **segments;
+  uint64_t size;
 } IAMF_Parameter;
 
 #define ANIMATED_PARAMETER_DEFINE(T1, T2)      \
@@ -343,6 +348,16 @@ struct ParameterSegment {
   uint64_t segment_interval;
 };
 
+/**
+ * The released segments of a parameter, which are reused by the following
+ * parameter blocks of the same parameter.
+ * */
+struct ParameterSegmentPool {
+  ParameterSegment **items;
+  int count;
+  int size;
+};
+
 typedef struct MixGainSegment {
   ParameterSegment seg;
   AnimatedParameter(short, uint8_t) mix_gain;
@@ -357,8 +372,8 @@ typedef struct DemixingSegment {
 typedef struct ReconGain {
   int layout;
   uint32_t flags;
-  uint8_t *recon_gain;
-  float *recon_gain_f;
+  uint8_t recon_gain[IA_CH_RE_COUNT];
+  float recon_gain_f[IA_CH_RE_COUNT];
 } ReconGain;
 
 typedef struct ReconGainList {
@@ -412,6 +427,16 @@ int IAMF_OBU_is_descrptor_OBU(IAMF_OBU *obu);
 uint64_t IAMF_OBU_get_object_id(IAMF_OBU *obu);
 const char *IAMF_OBU_type_string(IAMF_OBU_Type type);
 IAMF_Object *IAMF_object_new(IAMF_OBU *obu, IAMF_ObjectParameter *param);
+int IAMF_frame_init(IAMF_Frame *frame, IAMF_OBU *obu);
 void IAMF_object_free(IAMF_Object *obj);
+int IAMF_parameter_init(IAMF_Parameter *para, IAMF_OBU *obu,
+                        IAMF_ParameterParam *param);
+void IAMF_parameter_reset(IAMF_Parameter *para,
+                          ParameterSegmentPool *pool);
+ParameterSegment *IAMF_parameter_segment_new(ParameterSegmentPool *pool,
+                                             uint64_t type, int nb_layers);
 void IAMF_parameter_segment_free(ParameterSegment *seg);
+void IAMF_parameter_segment_release(ParameterSegmentPool *pool,
+                                    ParameterSegment *seg);
+void IAMF_parameter_segment_pool_clear(ParameterSegmentPool *pool);
 #endif
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdint.h>
 
 #include "IAMF_defines.h"
+#include "thread_pool.h"
 
 typedef struct IAMF_CodecContext {
   void *priv;
@@ -54,6 +55,8 @@ typedef struct IAMF_CodecContext {
   uint8_t streams;
   uint8_t coupled_streams;
   uint8_t channels;
+
+  ThreadPool *pool;
 } IAMF_CodecContext;
 
 typedef struct IAMF_Codec {
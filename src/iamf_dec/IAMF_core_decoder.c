@@ -74,6 +74,7 @@ struct IAMF_CoreDecoder {
   int ambisonics;
   void *matrix;
   void *buffer;
+  uint32_t frame_size;  // the samples per channel of buffer.
 };
 
 typedef struct FloatMatrix {
@@ -266,23 +267,35 @@ int iamf_core_decoder_set_streams_info(IAMF_CoreDecoder *ths, uint32_t mode,
   return IAMF_OK;
 }
 
+int iamf_core_decoder_set_frame_size(IAMF_CoreDecoder *ths,
+                                     uint32_t frame_size) {
+  IAMF_CodecContext *ctx = ths->ctx;
+  float *block;
+
+  if (ths->ambisonics == STREAM_MODE_AMBISONICS_NONE ||
+      frame_size <= ths->frame_size)
+    return IAMF_OK;
+
+  block = IAMF_REALLOC(float, ths->buffer,
+                       (ctx->coupled_streams + ctx->streams) * frame_size);
+  if (!block) return IAMF_ERR_ALLOC_FAIL;
+  ths->buffer = block;
+  ths->frame_size = frame_size;
+  return IAMF_OK;
+}
+
 int iamf_core_decoder_decode(IAMF_CoreDecoder *ths, uint8_t *buffer[],
                              uint32_t size[], uint32_t count, float *out,
-                             uint32_t frame_size) {
+                             uint32_t frame_size, ThreadPool *pool) {
   int ret = IAMF_OK;
   IAMF_CodecContext *ctx = ths->ctx;
   if (ctx->streams != count) return IAMF_ERR_BUFFER_TOO_SMALL;
+  ctx->pool = pool;
   if (ths->ambisonics == STREAM_MODE_AMBISONICS_NONE)
     return ths->cdec->decode(ctx, buffer, size, count, out, frame_size);
 
-  if (!ths->buffer) {
-    int c = ctx->coupled_streams + ctx->streams;
-    float *block = 0;
-
-    block = IAMF_MALLOC(float, c *frame_size);
-    if (!block) return IAMF_ERR_ALLOC_FAIL;
-    ths->buffer = block;
-  }
+  if (iamf_core_decoder_set_frame_size(ths, frame_size) != IAMF_OK)
+    return IAMF_ERR_ALLOC_FAIL;
   ret = ths->cdec->decode(ctx, buffer, size, count, ths->buffer, frame_size);
   if (ret > 0) {
     if (ths->ambisonics == STREAM_MODE_AMBISONICS_PROJECTION)
@@ -52,9 +52,11 @@ int iamf_core_decoder_set_streams_info(IAMF_CoreDecoder *ths, uint32_t mode,
                                        uint8_t coupled_streams,
                                        uint8_t mapping[],
                                        uint32_t mapping_size);
+int iamf_core_decoder_set_frame_size(IAMF_CoreDecoder *ths,
+                                     uint32_t frame_size);
 int iamf_core_decoder_decode(IAMF_CoreDecoder *ths, uint8_t *buffers[],
                              uint32_t *sizes, uint32_t count, float *out,
-                             uint32_t frame_size);
+                             uint32_t frame_size, ThreadPool *pool);
 int iamf_core_decoder_get_delay(IAMF_CoreDecoder *ths);
 
 #endif /* IAMF_CORE_DECODER_H_ */
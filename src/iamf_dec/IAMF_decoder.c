@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "bitstream.h"
 #include "demixer.h"
 #include "fixedp11_5.h"
+#include "sample_convert.h"
 #include "speex_resampler.h"
 
 #define INVALID_VALUE -1
@@ -95,112 +96,6 @@ static int64_t time_transform(int64_t t1, int s1, int s2) {
 }
 
 /* ----------------------------- Internal methods ------------------ */
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
-static int16_t FLOAT2INT16(float x) {
-  x = x * 32768.f;
-  x = MAX(x, -32768.f);
-  x = MIN(x, 32767.f);
-  return (int16_t)lrintf(x);
-}
-
-static int32_t FLOAT2INT24(float x) {
-  x = x * 8388608.f;
-  x = MAX(x, -8388608.f);
-  x = MIN(x, 8388607.f);
-  return (int32_t)lrintf(x);
-}
-
-static int32_t FLOAT2INT32(float x) {
-  x = x * 2147483648.f;
-  x = MAX(x, -2147483648.f);
-  x = MIN(x, 2147483647.f);
-  return (int32_t)lrintf(x);
-}
-
-static void iamf_decoder_plane2stride_out(void *dst, const float *src,
-                                          int frame_size, int channels,
-                                          uint32_t bit_depth, uint32_t stride) {
-  if (bit_depth == 16) {
-    int16_t *int16_dst = (int16_t *)dst;
-    memset(int16_dst, 0, 2 * frame_size * stride);
-    for (int c = 0; c < channels; ++c) {
-      for (int i = 0; i < frame_size; i++) {
-        if (src) {
-          int16_dst[i * stride + c] = FLOAT2INT16(src[frame_size * c + i]);
-        } else {
-          int16_dst[i * stride + c] = 0;
-        }
-      }
-    }
-  } else if (bit_depth == 24) {
-    uint8_t *int24_dst = (uint8_t *)dst;
-    memset(int24_dst, 0, 3 * frame_size * stride);
-    for (int c = 0; c < channels; ++c) {
-      for (int i = 0; i < frame_size; i++) {
-        if (src) {
-          int32_t tmp = FLOAT2INT24(src[frame_size * c + i]);
-          int24_dst[(i * stride + c) * 3] = tmp & 0xff;
-          int24_dst[(i * stride + c) * 3 + 1] = (tmp >> 8) & 0xff;
-          int24_dst[(i * stride + c) * 3 + 2] =
-              ((tmp >> 16) & 0x7f) | ((tmp >> 24) & 0x80);
-        } else {
-          int24_dst[(i * stride + c) * 3] = 0;
-          int24_dst[(i * stride + c) * 3 + 1] = 0;
-          int24_dst[(i * stride + c) * 3 + 2] = 0;
-        }
-      }
-    }
-  } else if (bit_depth == 32) {
-    int32_t *int32_dst = (int32_t *)dst;
-    memset(int32_dst, 0, 4 * frame_size * stride);
-    for (int c = 0; c < channels; ++c) {
-      for (int i = 0; i < frame_size; i++) {
-        if (src) {
-          int32_dst[i * stride + c] = FLOAT2INT32(src[frame_size * c + i]);
-        } else {
-          int32_dst[i * stride + c] = 0;
-        }
-      }
-    }
-  }
-}
-static void ia_decoder_stride2plane_out_float(void *dst, const float *src,
-                                              int frame_size, int channels) {
-  float *float_dst = (float *)dst;
-
-  ia_logd("channels %d", channels);
-  for (int i = 0; i < frame_size; i++) {
-    if (src) {
-      for (int c = 0; c < channels; ++c) {
-        float_dst[c * frame_size + i] = src[channels * i + c];
-      }
-    } else {
-      for (int c = 0; c < channels; ++c) {
-        float_dst[c * frame_size + i] = 0;
-      }
-    }
-  }
-}
-
-static void ia_decoder_plane2stride_out_float(void *dst, const float *src,
-                                              int frame_size, int channels) {
-  float *float_dst = (float *)dst;
-
-  ia_logd("channels %d", channels);
-  for (int c = 0; c < channels; ++c) {
-    if (src) {
-      for (int i = 0; i < frame_size; i++) {
-        float_dst[i * channels + c] = src[frame_size * c + i];
-      }
-    } else {
-      for (int i = 0; i < frame_size; i++) {
-        float_dst[i * channels + c] = 0;
-      }
-    }
-  }
-}
-
 static int iamf_sound_system_valid(IAMF_SoundSystem ss) {
   return ss > SOUND_SYSTEM_INVALID && ss < SOUND_SYSTEM_END;
 }
@@ -620,6 +515,7 @@ static int32_t iamf_stream_scale_decoder_demix(IAMF_StreamDecoder *decoder,
                                                uint32_t frame_size);
 static int iamf_stream_ambisonics_decoder_decode(IAMF_StreamDecoder *decoder,
                                                  float *pcm);
+static int iamf_decoder_pipeline_prepare(IAMF_DecoderHandle handle);
 
 /* >>>>>>>>>>>>>>>>>> DATABASE >>>>>>>>>>>>>>>>>> */
 
@@ -629,13 +525,6 @@ static IAMF_CodecConf *iamf_database_get_codec_conf(IAMF_DataBase *db,
 static ElementItem *iamf_database_element_get_item(IAMF_DataBase *db,
                                                    uint64_t eid);
 
-static void mix_gain_unit_free(MixGainUnit *u) {
-  if (u) {
-    IAMF_FREE(u->gains);
-    free(u);
-  }
-}
-
 static int mix_gain_bezier_linear(float s, float e, int d, int o, uint32_t l,
                                   float *g) {
   int oe = o + l;
@@ -648,21 +537,51 @@ static int mix_gain_bezier_quad(float s, float e, int d, float c, int ct, int o,
                                 uint32_t l, float *g) {
   int oe = o + l;
   int64_t alpha = d - 2 * ct;
+  double ct2 = (double)ct * ct;
   float a = 1.0f;
 
+  // the squares are exact in double, which are the same as pow(x, 2).
   for (int i = o, k = 0; i < oe; ++i, ++k) {
     if (alpha) {
-      a = (sqrt(pow(ct, 2) + alpha * i) - ct) / alpha;
+      a = (sqrt(ct2 + alpha * i) - ct) / alpha;
     } else {
       a = i;
       a /= (2 * ct);
     }
-    g[k] = (s + e - 2 * c) * pow(a, 2) + 2 * a * (c - s) + s;
+    g[k] = (s + e - 2 * c) * ((double)a * a) + 2 * a * (c - s) + s;
   }
 
   return IAMF_OK;
 }
 
+static void mix_gain_unit_add_step(MixGainUnit *mgu, int count, float gain) {
+  MixGainRun *r = mgu->nb_runs ? &mgu->runs[mgu->nb_runs - 1] : 0;
+
+  if (count <= 0) return;
+  if (r && !r->gains && r->gain == gain) {
+    r->count += count;
+  } else {
+    r = &mgu->runs[mgu->nb_runs++];
+    r->count = count;
+    r->gain = gain;
+    r->gains = 0;
+  }
+  mgu->count += count;
+}
+
+/* returns the storage of the gains of the next count samples. */
+static float *mix_gain_unit_add_curve(MixGainUnit *mgu, int count) {
+  MixGainRun *r;
+
+  if (count <= 0) return mgu->buffer + mgu->count;
+  r = &mgu->runs[mgu->nb_runs++];
+  r->count = count;
+  r->gain = 0.f;
+  r->gains = mgu->buffer + mgu->count;
+  mgu->count += count;
+  return r->gains;
+}
+
 static void iamf_object_free(void *obj) { IAMF_object_free(IAMF_OBJ(obj)); }
 
 static ObjectSet *iamf_object_set_new(IAMF_Free func) {
@@ -750,20 +669,84 @@ static int iamf_codec_conf_get_sampling_rate(IAMF_CodecConf *c) {
   return IAMF_ERR_BAD_ARG;
 }
 
-static void iamf_parameter_item_clear_segments(ParameterItem *pi) {
-  if (pi && pi->value.params) {
-    queue_t *q = pi->value.params;
-    while (queue_length(q) > 0) {
-      ParameterSegment *seg = queue_pop(q);
-      IAMF_parameter_segment_free(seg);
+static int iamf_parameter_segments_push(ParameterSegments *ps,
+                                        ParameterSegment *seg) {
+  uint64_t end = ps->count ? ps->ends[ps->head + ps->count - 1] : ps->start;
+
+  if (ps->head + ps->count == ps->size) {
+    if (ps->head > 0) {
+      memmove(ps->items, ps->items + ps->head,
+              sizeof(ParameterSegment *) * ps->count);
+      memmove(ps->ends, ps->ends + ps->head, sizeof(uint64_t) * ps->count);
+      ps->head = 0;
+    } else {
+      int size = ps->size ? ps->size * 2 : 8;
+      ParameterSegment **items =
+          IAMF_REALLOC(ParameterSegment *, ps->items, size);
+      uint64_t *ends;
+
+      if (!items) return IAMF_ERR_ALLOC_FAIL;
+      ps->items = items;
+      ends = IAMF_REALLOC(uint64_t, ps->ends, size);
+      if (!ends) return IAMF_ERR_ALLOC_FAIL;
+      ps->ends = ends;
+      ps->size = size;
     }
   }
+
+  ps->items[ps->head + ps->count] = seg;
+  ps->ends[ps->head + ps->count] = end + seg->segment_interval;
+  ++ps->count;
+  return IAMF_OK;
+}
+
+static ParameterSegment *iamf_parameter_segments_front(ParameterSegments *ps) {
+  return ps->count ? ps->items[ps->head] : 0;
+}
+
+static void iamf_parameter_segments_pop(ParameterSegments *ps) {
+  if (!ps->count) return;
+  ps->start = ps->ends[ps->head++];
+  if (!--ps->count) ps->head = 0;
+}
+
+/**
+ * Finds the segment which covers the offset from the start of the first one,
+ * returns its index or -1.
+ * */
+static int iamf_parameter_segments_find(ParameterSegments *ps,
+                                        uint64_t offset) {
+  uint64_t *ends = ps->ends + ps->head;
+  uint64_t t = ps->start + offset;
+  int l = 0, r = ps->count;
+
+  while (l < r) {
+    int m = (l + r) / 2;
+    if (ends[m] > t)
+      r = m;
+    else
+      l = m + 1;
+  }
+  return l < ps->count ? l : -1;
+}
+
+static void iamf_parameter_segments_clear(ParameterSegments *ps,
+                                          ParameterSegmentPool *pool) {
+  for (int i = 0; i < ps->count; ++i)
+    IAMF_parameter_segment_release(pool, ps->items[ps->head + i]);
+  ps->start = 0;
+  ps->head = 0;
+  ps->count = 0;
 }
 
 static void iamf_parameter_item_free(void *e) {
   ParameterItem *pi = (ParameterItem *)e;
-  iamf_parameter_item_clear_segments(pi);
-  if (pi && pi->value.params) queue_free(pi->value.params);
+  if (pi) {
+    iamf_parameter_segments_clear(&pi->value.segments, 0);
+    IAMF_FREE(pi->value.segments.items);
+    IAMF_FREE(pi->value.segments.ends);
+    IAMF_parameter_segment_pool_clear(&pi->pool);
+  }
   IAMF_FREE(pi);
 }
 
@@ -774,21 +757,67 @@ static void iamf_database_viewer_reset(Viewer *v) {
     for (int i = 0; i < v->count; ++i) ff(v->items[i]);
     free(v->items);
   }
+  IAMF_FREE(v->index);
   v->count = 0;
   v->items = 0;
+  v->index = 0;
+  v->index_size = 0;
+}
+
+static uint32_t iamf_database_viewer_hash(uint64_t id) {
+  id ^= id >> 33;
+  id *= 0xff51afd7ed558ccdULL;
+  id ^= id >> 33;
+  return (uint32_t)id;
+}
+
+static void iamf_database_viewer_index(ViewerEntry *index, int size,
+                                       uint64_t id, void *item) {
+  uint32_t k = iamf_database_viewer_hash(id) & (size - 1);
+  while (index[k].item) k = (k + 1) & (size - 1);
+  index[k].id = id;
+  index[k].item = item;
+}
+
+static void *iamf_database_viewer_find(Viewer *v, uint64_t id) {
+  uint32_t k;
+
+  if (!v->index_size) return 0;
+  k = iamf_database_viewer_hash(id) & (v->index_size - 1);
+  for (; v->index[k].item; k = (k + 1) & (v->index_size - 1))
+    if (v->index[k].id == id) return v->index[k].item;
+  return 0;
+}
+
+static int iamf_database_viewer_add(Viewer *v, uint64_t id, void *item) {
+  void **items = IAMF_REALLOC(void *, v->items, v->count + 1);
+
+  if (!items) return IAMF_ERR_ALLOC_FAIL;
+  v->items = items;
+
+  // keep the load factor of the index not greater than 1/2.
+  if ((v->count + 1) * 2 > v->index_size) {
+    int size = v->index_size ? v->index_size * 2 : 16;
+    ViewerEntry *index = IAMF_MALLOCZ(ViewerEntry, size);
+
+    if (!index) return IAMF_ERR_ALLOC_FAIL;
+    for (int i = 0; i < v->index_size; ++i)
+      if (v->index[i].item)
+        iamf_database_viewer_index(index, size, v->index[i].id,
+                                   v->index[i].item);
+    IAMF_FREE(v->index);
+    v->index = index;
+    v->index_size = size;
+  }
+
+  iamf_database_viewer_index(v->index, v->index_size, id, item);
+  v->items[v->count++] = item;
+  return IAMF_OK;
 }
 
 static ParameterItem *iamf_database_parameter_viewer_get_item(Viewer *viewer,
                                                               uint64_t pid) {
-  ParameterItem *pi = 0, *vpi;
-  for (int i = 0; i < viewer->count; ++i) {
-    vpi = (ParameterItem *)viewer->items[i];
-    if (vpi->id == pid) {
-      pi = vpi;
-      break;
-    }
-  }
-  return pi;
+  return (ParameterItem *)iamf_database_viewer_find(viewer, pid);
 }
 
 static ParameterItem *iamf_database_parameter_get_item(IAMF_DataBase *db,
@@ -813,9 +842,8 @@ static ParameterSegment *iamf_database_parameter_get_segment(IAMF_DataBase *db,
                                                              uint64_t pts) {
   ParameterItem *pi =
       iamf_database_parameter_viewer_get_item(&db->pViewer, pid);
-  ParameterSegment *seg = 0, *s = 0;
   uint64_t start = 0;
-  int count = 0;
+  int k;
 
   if (!pi) return 0;
   if (!iamf_database_parameter_check_timestamp(db, pi->id, pts)) {
@@ -826,18 +854,8 @@ static ParameterSegment *iamf_database_parameter_get_segment(IAMF_DataBase *db,
   } else
     start = pts - pi->timestamp;
 
-  count = pi->value.params ? queue_length(pi->value.params) : 0;
-  for (int i = 0; i < count; ++i) {
-    s = queue_take(pi->value.params, i);
-    if (!s) break;
-    if (start < s->segment_interval) {
-      seg = s;
-      break;
-    } else {
-      start -= s->segment_interval;
-    }
-  }
-  return seg;
+  k = iamf_parameter_segments_find(&pi->value.segments, start);
+  return k < 0 ? 0 : pi->value.segments.items[pi->value.segments.head + k];
 }
 
 static int iamf_database_parameter_get_demix_mode(IAMF_DataBase *db,
@@ -855,9 +873,9 @@ static ReconGainList *iamf_database_parameter_get_recon_gain_list(
 }
 
 static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
-    IAMF_DataBase *db, uint64_t pid, uint64_t pt, int duration, int rate) {
+    IAMF_DataBase *db, uint64_t pid, uint64_t pt, int duration, int rate,
+    MixGainUnit *mgu) {
   ParameterItem *pi = 0;
-  MixGainUnit *mgu = 0;
   uint64_t start = 0;
   float ratio = 1.f;
   int use_default = 0;
@@ -877,8 +895,9 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
   } else
     start = pt - pi->timestamp;
 
-  mgu = IAMF_MALLOCZ(MixGainUnit, 1);
-  if (!mgu) return 0;
+  mgu->count = 0;
+  mgu->constant_gain = 0.f;
+  mgu->nb_runs = 0;
 
   if (pi->value.mix_gain.use_default || use_default) {
     ia_logd("use default mix gain %f", pi->value.mix_gain.default_mix_gain);
@@ -889,21 +908,30 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
     int64_t minterval = 0;
     int left = duration;
     MixGainSegment *seg = 0;
+    ParameterSegments *ps = &pi->value.segments;
+    int i = 0;
 
-    if (!pi->param_base || !pi->value.params) {
-      mix_gain_unit_free(mgu);
+    if (!pi->param_base) return 0;
+    if (duration > mgu->size) {
+      ia_loge("The duration %d is greater than the gains size %d.", duration,
+              mgu->size);
       return 0;
     }
 
     if (rate != pi->param_base->rate)
       ratio = (rate + 0.1f) / pi->param_base->rate;
 
-    for (int i = 0; i < queue_length(pi->value.params); ++i) {
-      seg = (MixGainSegment *)queue_take(pi->value.params, i);
-      if (!seg) {
-        ia_loge("Can't find %d-th segment", i);
-        break;
-      }
+    // the scaled intervals are accumulated one by one with another rate.
+    if (ratio == 1.f) {
+      i = iamf_parameter_segments_find(ps, start);
+      if (i < 0)
+        i = ps->count;
+      else if (i > 0)
+        sgd = ps->ends[ps->head + i - 1] - ps->start;
+    }
+
+    for (; i < ps->count; ++i) {
+      seg = (MixGainSegment *)ps->items[ps->head + i];
       minterval = seg->seg.segment_interval * ratio;
       sgd += minterval;
       if (start < sgd) {
@@ -915,15 +943,7 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
             mgu->count = duration;
             ia_logd("use constant mix gain %f", seg->mix_gain_f.start);
           } else if (!mgu->count) {
-            mgu->gains = IAMF_MALLOC(float, duration);
-            if (!mgu->gains) {
-              ia_loge("Fail to allocate gains of mix gain unit.");
-              mix_gain_unit_free(mgu);
-              return 0;
-            }
-            mgu->count = sgd - start;
-            for (int i = 0; i < mgu->count; ++i)
-              mgu->gains[i] = seg->mix_gain_f.start;
+            mix_gain_unit_add_step(mgu, sgd - start, seg->mix_gain_f.start);
             start = sgd;
             ia_logd("step-1: get %d gains", mgu->count);
           } else {
@@ -934,24 +954,15 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
               start = sgd;
               e = mgu->count + minterval;
             }
-            for (int i = mgu->count; i < e; ++i)
-              mgu->gains[i] = seg->mix_gain_f.start;
             ia_logd("step-2: get %d gains", e - mgu->count);
-            mgu->count = e;
+            mix_gain_unit_add_step(mgu, e - mgu->count, seg->mix_gain_f.start);
           }
         } else {
           int off = 0;
           int ss = sgd - minterval;
           int d = 0;
+          float *g;
           off = start - ss;
-          if (!mgu->gains) {
-            mgu->gains = IAMF_MALLOC(float, duration);
-            if (!mgu->gains) {
-              ia_loge("Fail to allocate gains of mix gain unit.");
-              mix_gain_unit_free(mgu);
-              return 0;
-            }
-          }
 
           if (start + left <= sgd) {
             d = left;
@@ -960,16 +971,16 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
             start = sgd;
             left -= d;
           }
+          g = mix_gain_unit_add_curve(mgu, d);
           if (seg->mix_gain.animated_type == PARAMETER_ANIMATED_TYPE_LINEAR)
             mix_gain_bezier_linear(seg->mix_gain_f.start, seg->mix_gain_f.end,
-                                   minterval, off, d, mgu->gains + mgu->count);
+                                   minterval, off, d, g);
           else
             mix_gain_bezier_quad(
                 seg->mix_gain_f.start, seg->mix_gain_f.end, minterval,
                 seg->mix_gain_f.control,
                 seg->mix_gain_f.control_relative_time * (minterval + .1f), off,
-                d, mgu->gains + mgu->count);
-          mgu->count += d;
+                d, g);
           ia_logd("not step: get %d gains", d);
         }
       }
@@ -981,14 +992,42 @@ static MixGainUnit *iamf_database_parameter_get_mix_gain_unit(
   return mgu;
 }
 
+/**
+ * Reserves the segments of a parameter in configuration, then the parameter
+ * blocks reuse the released segments rather than allocating in decoding.
+ * */
+static int iamf_parameter_item_reserve(ParameterItem *pi, int nb_layers) {
+  ParameterSegments *ps = &pi->value.segments;
+  ParameterSegmentPool *pool = &pi->pool;
+  int n = PARAMETER_SEGMENTS_RESERVED;
+
+  if (pi->type != IAMF_PARAMETER_TYPE_MIX_GAIN &&
+      pi->type != IAMF_PARAMETER_TYPE_DEMIXING &&
+      pi->type != IAMF_PARAMETER_TYPE_RECON_GAIN)
+    return IAMF_OK;
+
+  ps->items = IAMF_MALLOC(ParameterSegment *, n);
+  ps->ends = IAMF_MALLOC(uint64_t, n);
+  pool->items = IAMF_MALLOC(ParameterSegment *, n);
+  if (!ps->items || !ps->ends || !pool->items) return IAMF_ERR_ALLOC_FAIL;
+  ps->size = pool->size = n;
+
+  while (pool->count < n) {
+    ParameterSegment *seg = IAMF_parameter_segment_new(0, pi->type, nb_layers);
+    if (!seg) return IAMF_ERR_ALLOC_FAIL;
+    pool->items[pool->count++] = seg;
+  }
+  return IAMF_OK;
+}
+
 static int iamf_database_parameter_add_item(IAMF_DataBase *db,
                                             ParameterBase *base,
                                             uint64_t parent_id, int rate) {
   Viewer *pv = &db->pViewer;
   ParameterItem *pi = 0;
-  ParameterItem **pis = 0;
   ElementItem *ei = 0;
   uint64_t pid, type;
+  int nb_layers = 0;
 
   if (!base) return IAMF_ERR_BAD_ARG;
 
@@ -1001,16 +1040,10 @@ static int iamf_database_parameter_add_item(IAMF_DataBase *db,
     return IAMF_OK;
   }
 
-  pis = IAMF_REALLOC(ParameterItem *, pv->items, pv->count + 1);
-  if (!pis) return IAMF_ERR_ALLOC_FAIL;
-  pv->items = (void **)pis;
-  pis[pv->count] = 0;
-
   pi = IAMF_MALLOCZ(ParameterItem, 1);
   if (!pi) return IAMF_ERR_ALLOC_FAIL;
 
-  pi->value.params = queue_new();
-  if (!pi->value.params) {
+  if (iamf_database_viewer_add(pv, pid, pi) != IAMF_OK) {
     free(pi);
     return IAMF_ERR_ALLOC_FAIL;
   }
@@ -1018,7 +1051,6 @@ static int iamf_database_parameter_add_item(IAMF_DataBase *db,
   // use default mix gain.
   if (type == IAMF_PARAMETER_TYPE_MIX_GAIN) pi->value.mix_gain.use_default = 1;
 
-  pis[pv->count++] = pi;
   ia_logd("add parameter item %p, its id %" PRIu64 ", and count is %d", pi, pid,
           pv->count);
 
@@ -1033,10 +1065,14 @@ static int iamf_database_parameter_add_item(IAMF_DataBase *db,
     if (type == IAMF_PARAMETER_TYPE_DEMIXING) {
       ei->demixing = pi;
     } else if (type == IAMF_PARAMETER_TYPE_RECON_GAIN) {
+      IAMF_Element *e = ei->element;
       ei->reconGain = pi;
+      if (e->element_type == AUDIO_ELEMENT_TYPE_CHANNEL_BASED &&
+          e->channels_conf && e->channels_conf->layer_conf_s)
+        nb_layers = e->channels_conf->nb_layers;
     }
   }
-  return IAMF_OK;
+  return iamf_parameter_item_reserve(pi, nb_layers);
 }
 
 static int iamf_database_parameter_add(IAMF_DataBase *db, IAMF_Object *obj) {
@@ -1057,7 +1093,11 @@ static int iamf_database_parameter_add(IAMF_DataBase *db, IAMF_Object *obj) {
     }
 
     for (int i = 0; i < p->nb_segments; ++i) {
-      queue_push(pi->value.params, p->segments[i]);
+      if (iamf_parameter_segments_push(&pi->value.segments, p->segments[i]) !=
+          IAMF_OK) {
+        ia_loge("Fail to store the segments of parameter %" PRIu64, p->id);
+        break;
+      }
       pi->duration += p->segments[i]->segment_interval;
       p->segments[i] = 0;
     }
@@ -1070,18 +1110,11 @@ static int iamf_database_parameter_add(IAMF_DataBase *db, IAMF_Object *obj) {
   return IAMF_OK;
 }
 
-static ParameterBase *iamf_database_parameter_viewer_get_parmeter_base(
-    IAMF_DataBase *db, uint64_t pid) {
-  ParameterItem *pi =
-      iamf_database_parameter_viewer_get_item(&db->pViewer, pid);
-  return pi ? pi->param_base : 0;
-}
-
 static int iamf_database_parameters_clear_segments(IAMF_DataBase *db) {
   ParameterItem *pi = 0;
   for (int i = 0; i < db->pViewer.count; ++i) {
     pi = (ParameterItem *)db->pViewer.items[i];
-    iamf_parameter_item_clear_segments(pi);
+    iamf_parameter_segments_clear(&pi->value.segments, &pi->pool);
   }
   return IAMF_OK;
 }
@@ -1101,24 +1134,20 @@ static int iamf_database_parameters_time_elapse(IAMF_DataBase *db,
             pi->id, pi->timestamp, pi->duration, pi->elapse,
             pi->param_base->rate, duration, rate);
 
-    if (pi->value.params) {
-      pi->elapse += time_transform(duration, rate, pi->param_base->rate);
-      while (1) {
-        // ia_logd("length %d", queue_length(pi->value.params));
-        seg = (ParameterSegment *)queue_take(pi->value.params, 0);
-        if (seg && seg->segment_interval <= pi->elapse) {
-          pi->timestamp += seg->segment_interval;
-          pi->duration -= seg->segment_interval;
-          pi->elapse -= seg->segment_interval;
-          // ia_logd("pi %p, pid %" PRIu64", pop segment %p", pi, pi->id, seg);
-          queue_pop(pi->value.params);
-          IAMF_parameter_segment_free(seg);
-        } else {
-          ia_logd("E: pid %" PRIu64 " pts %" PRIu64 ", duration %" PRIu64
-                  ", elapsed %" PRIu64,
-                  pi->id, pi->timestamp, pi->duration, pi->elapse);
-          break;
-        }
+    pi->elapse += time_transform(duration, rate, pi->param_base->rate);
+    while (1) {
+      seg = iamf_parameter_segments_front(&pi->value.segments);
+      if (seg && seg->segment_interval <= pi->elapse) {
+        pi->timestamp += seg->segment_interval;
+        pi->duration -= seg->segment_interval;
+        pi->elapse -= seg->segment_interval;
+        iamf_parameter_segments_pop(&pi->value.segments);
+        IAMF_parameter_segment_release(&pi->pool, seg);
+      } else {
+        ia_logd("E: pid %" PRIu64 " pts %" PRIu64 ", duration %" PRIu64
+                ", elapsed %" PRIu64,
+                pi->id, pi->timestamp, pi->duration, pi->elapse);
+        break;
       }
     }
   }
@@ -1129,7 +1158,6 @@ static int iamf_database_element_add(IAMF_DataBase *db, IAMF_Object *obj) {
   int ret = IAMF_OK;
   int rate = 0;
   ElementItem *ei = 0;
-  ElementItem **eItem = 0;
   Viewer *v = &db->eViewer;
   IAMF_Element *e = (IAMF_Element *)obj;
 
@@ -1139,18 +1167,16 @@ static int iamf_database_element_add(IAMF_DataBase *db, IAMF_Object *obj) {
     return IAMF_OK;
   }
 
-  eItem = IAMF_REALLOC(ElementItem *, v->items, v->count + 1);
-  if (!eItem) return IAMF_ERR_ALLOC_FAIL;
-  eItem[v->count] = 0;
-
-  v->items = (void **)eItem;
   ret = iamf_object_set_add(db->element, (void *)obj);
   if (ret != IAMF_OK) return ret;
 
   ei = IAMF_MALLOCZ(ElementItem, 1);
   if (!ei) return IAMF_ERR_ALLOC_FAIL;
 
-  v->items[v->count++] = ei;
+  if (iamf_database_viewer_add(v, e->element_id, ei) != IAMF_OK) {
+    free(ei);
+    return IAMF_ERR_ALLOC_FAIL;
+  }
   ei->id = e->element_id;
   ei->element = IAMF_ELEMENT(obj);
   ei->codecConf = iamf_database_get_codec_conf(db, e->codec_config_id);
@@ -1171,8 +1197,12 @@ int iamf_database_init(IAMF_DataBase *db) {
   db->mixPresentation = iamf_object_set_new(iamf_object_free);
   db->eViewer.freeF = free;
   db->pViewer.freeF = iamf_parameter_item_free;
+  db->param.segments =
+      IAMF_MALLOCZ(ParameterSegment *, PARAMETER_SEGMENTS_RESERVED);
+  db->param.size = PARAMETER_SEGMENTS_RESERVED;
 
-  if (!db->codecConf || !db->element || !db->mixPresentation) {
+  if (!db->codecConf || !db->element || !db->mixPresentation ||
+      !db->param.segments) {
     iamf_database_reset(db);
     return IAMF_ERR_ALLOC_FAIL;
   }
@@ -1189,6 +1219,9 @@ void iamf_database_reset(IAMF_DataBase *db) {
     iamf_database_viewer_reset(&db->eViewer);
     iamf_database_viewer_reset(&db->pViewer);
 
+    IAMF_parameter_reset(&db->param, 0);
+    IAMF_FREE(db->param.segments);
+
     memset(db, 0, sizeof(IAMF_DataBase));
   }
 }
@@ -1289,32 +1322,7 @@ static IAMF_MixPresentation *iamf_database_get_mix_presentation(
 }
 
 ElementItem *iamf_database_element_get_item(IAMF_DataBase *db, uint64_t eid) {
-  ElementItem *ei = 0, *vei;
-  for (int i = 0; i < db->eViewer.count; ++i) {
-    vei = (ElementItem *)db->eViewer.items[i];
-    if (vei->id == eid) {
-      ei = vei;
-      break;
-    }
-  }
-  return ei;
-}
-
-static int iamf_database_element_get_substream_index(IAMF_DataBase *db,
-                                                     uint64_t element_id,
-                                                     uint64_t substream_id) {
-  IAMF_Element *obj = iamf_database_get_element(db, element_id);
-  int ret = -1;
-
-  if (obj) {
-    for (int i = 0; i < obj->nb_substreams; ++i) {
-      if (obj->substream_ids[i] == substream_id) {
-        ret = i;
-        break;
-      }
-    }
-  }
-  return ret;
+  return (ElementItem *)iamf_database_viewer_find(&db->eViewer, eid);
 }
 
 static IAMF_CodecConf *iamf_database_element_get_codec_conf(IAMF_DataBase *db,
@@ -1345,6 +1353,9 @@ static IAMF_StreamRenderer *iamf_stream_renderer_open(IAMF_Stream *s,
                                                       IAMF_MixPresentation *mp,
                                                       int frame_size);
 static int iamf_stream_renderer_enable_downmix(IAMF_StreamRenderer *sr);
+static uint32_t iamf_stream_renderer_input_mask(IAMF_StreamRenderer *sr);
+static void iamf_stream_scale_demixer_set_demand(IAMF_StreamDecoder *decoder,
+                                                 IAMF_StreamRenderer *sr);
 static void iamf_stream_renderer_close(IAMF_StreamRenderer *sr);
 static void iamf_mixer_reset(IAMF_Mixer *m);
 static int iamf_stream_scale_decoder_update_recon_gain(
@@ -1354,10 +1365,6 @@ static SpeexResamplerState *iamf_stream_resampler_open(IAMF_Stream *stream,
                                                        int quality);
 static void iamf_stream_resampler_close(SpeexResamplerState *r);
 
-static int iamf_packet_check_count(Packet *pkt) {
-  return pkt->count == pkt->nb_sub_packets;
-}
-
 static int iamf_frame_trim(Frame *f, int start, int end, int start_extension) {
   int s, ret;
   s = start + start_extension;
@@ -1380,8 +1387,67 @@ static int iamf_frame_trim(Frame *f, int start, int end, int start_extension) {
   return ret;
 }
 
+/**
+ * Scales the samples of the channels by the gains. The products are added to
+ * out if accumulate, otherwise they are stored to out, which may be in.
+ * */
+static void iamf_mix_gain_apply(MixGainUnit *gain, float *out, const float *in,
+                                int samples, int channels, int accumulate) {
+  int count = samples * channels;
+
+  if (!gain || !gain->nb_runs) {
+    float g = 1.f;
+    if (gain && gain->constant_gain != 1.f && gain->constant_gain > 0.f)
+      g = gain->constant_gain;
+
+    if (g != 1.f) {
+      if (accumulate)
+        for (int i = 0; i < count; ++i) out[i] += in[i] * g;
+      else
+        for (int i = 0; i < count; ++i) out[i] = in[i] * g;
+    } else if (accumulate) {
+      for (int i = 0; i < count; ++i) out[i] += in[i];
+    } else if (out != in) {
+      memcpy(out, in, sizeof(float) * count);
+    }
+    return;
+  }
+
+  for (int c = 0; c < channels; ++c) {
+    float *o = out + c * samples;
+    const float *x = in + c * samples;
+    int k = 0;
+
+    for (int r = 0; r < gain->nb_runs && k < samples; ++r) {
+      MixGainRun *run = &gain->runs[r];
+      int n = run->count < samples - k ? run->count : samples - k;
+      float *g = run->gains;
+      float v = run->gain;
+
+      if (g && accumulate)
+        for (int i = 0; i < n; ++i) o[k + i] += x[k + i] * g[i];
+      else if (g)
+        for (int i = 0; i < n; ++i) o[k + i] = x[k + i] * g[i];
+      else if (accumulate)
+        for (int i = 0; i < n; ++i) o[k + i] += x[k + i] * v;
+      else
+        for (int i = 0; i < n; ++i) o[k + i] = x[k + i] * v;
+      k += n;
+    }
+  }
+}
+
+/* the gain is not applied if it is shorter than the frame. */
+static MixGainUnit *iamf_mix_gain_check(MixGainUnit *gain, int samples) {
+  if (gain && samples > gain->count) {
+    ia_logd("frame samples should be not greater than gain count %d vs %d",
+            samples, gain->count);
+    return 0;
+  }
+  return gain;
+}
+
 static int iamf_frame_gain(Frame *f, MixGainUnit *gain) {
-  int soff;
   if (!gain) return IAMF_ERR_BAD_ARG;
   if (f->samples > gain->count) {
     ia_logd("frame samples should be not greater than gain count %d vs %d",
@@ -1389,20 +1455,9 @@ static int iamf_frame_gain(Frame *f, MixGainUnit *gain) {
     return IAMF_ERR_INTERNAL;
   }
 
-  if (!gain->gains) {
-    ia_logd("use constant gain %f.", gain->constant_gain);
-    if (gain->constant_gain != 1.f && gain->constant_gain > 0.f) {
-      int count = f->samples * f->channels;
-      for (int i = 0; i < count; ++i) f->data[i] *= gain->constant_gain;
-    }
-    return IAMF_OK;
-  }
-
-  ia_logd("use gains %f -> %f", gain->gains[0], gain->gains[gain->count - 1]);
-  for (int c = 0; c < f->channels; ++c) {
-    soff = c * f->samples;
-    for (int i = 0; i < f->samples; ++i) f->data[soff + i] *= gain->gains[i];
-  }
+  ia_logd("use constant gain %f or %d runs.", gain->constant_gain,
+          gain->nb_runs);
+  iamf_mix_gain_apply(gain, f->data, f->data, f->samples, f->channels, 0);
 
   return IAMF_OK;
 }
@@ -1419,11 +1474,98 @@ static void iamf_presentation_free(IAMF_Presentation *pst) {
     free(pst->renderers);
     free(pst->decoders);
     free(pst->streams);
+    IAMF_FREE(pst->arena);
+    IAMF_FREE(pst->routes);
     iamf_mixer_reset(&pst->mixer);
     free(pst);
   }
 }
 
+/**
+ * Builds the table from the substream ids to the streams. The id is owned by
+ * the first stream if it is used by multiple streams.
+ * */
+static int iamf_presentation_route_substreams(IAMF_Presentation *pst,
+                                              IAMF_DataBase *db) {
+  IAMF_Element *e;
+  int count = 0, size = 16;
+  uint32_t k;
+
+  for (int i = 0; i < pst->nb_streams; ++i)
+    count += pst->streams[i]->nb_substreams;
+  while (size < count * 2) size *= 2;
+
+  IAMF_FREE(pst->routes);
+  pst->routes = IAMF_MALLOC(SubstreamRoute, size);
+  pst->routes_size = 0;
+  if (!pst->routes) return IAMF_ERR_ALLOC_FAIL;
+  for (int i = 0; i < size; ++i) pst->routes[i].stream = INVALID_VALUE;
+  pst->routes_size = size;
+
+  for (int i = 0; i < pst->nb_streams; ++i) {
+    e = iamf_database_get_element(db, pst->streams[i]->element_id);
+    if (!e) continue;
+    for (int s = 0; s < e->nb_substreams; ++s) {
+      k = iamf_database_viewer_hash(e->substream_ids[s]) & (size - 1);
+      while (pst->routes[k].stream != INVALID_VALUE &&
+             pst->routes[k].id != e->substream_ids[s])
+        k = (k + 1) & (size - 1);
+      if (pst->routes[k].stream != INVALID_VALUE) continue;
+      pst->routes[k].id = e->substream_ids[s];
+      pst->routes[k].stream = i;
+      pst->routes[k].index = s;
+    }
+  }
+
+  return IAMF_OK;
+}
+
+static SubstreamRoute *iamf_presentation_get_route(IAMF_Presentation *pst,
+                                                   uint64_t id) {
+  uint32_t k;
+
+  if (!pst->routes_size) return 0;
+  k = iamf_database_viewer_hash(id) & (pst->routes_size - 1);
+  for (; pst->routes[k].stream != INVALID_VALUE;
+       k = (k + 1) & (pst->routes_size - 1))
+    if (pst->routes[k].id == id) return &pst->routes[k];
+  return 0;
+}
+
+static int iamf_presentation_arena_init(IAMF_Presentation *pst,
+                                        uint32_t frame_size) {
+  uint32_t tsize = sizeof(IAMF_StreamTask) * pst->nb_streams;
+  uint32_t rsize = sizeof(MixGainRun) * frame_size;
+  uint32_t gsize = rsize + sizeof(float) * frame_size;
+  uint32_t dsize = sizeof(float) * frame_size * pst->frame.channels;
+  uint8_t *p;
+
+  IAMF_FREE(pst->arena);
+  pst->tasks = 0;
+
+  pst->arena = IAMF_MALLOCZ(
+      uint8_t, tsize + gsize * (pst->nb_streams + 1) + dsize * 2);
+  if (!pst->arena) return IAMF_ERR_ALLOC_FAIL;
+
+  p = pst->arena;
+  pst->tasks = (IAMF_StreamTask *)p;
+  p += tsize;
+  // a run has one sample at least.
+  for (int i = 0; i < pst->nb_streams; ++i, p += gsize) {
+    pst->tasks[i].gain.runs = (MixGainRun *)p;
+    pst->tasks[i].gain.buffer = (float *)(p + rsize);
+    pst->tasks[i].gain.size = frame_size;
+  }
+  pst->output_gain.runs = (MixGainRun *)p;
+  pst->output_gain.buffer = (float *)(p + rsize);
+  pst->output_gain.size = frame_size;
+  p += gsize;
+  pst->buffers[0] = (float *)p;
+  pst->buffers[1] = (float *)(p + dsize);
+
+  return IAMF_OK;
+}
+
 static IAMF_Stream *iamf_presentation_take_stream(IAMF_Presentation *pst,
                                                   uint64_t eid) {
   IAMF_Stream *stream = 0;
@@ -1857,6 +1999,7 @@ static int iamf_stream_enable(IAMF_DecoderHandle handle, IAMF_Element *elem) {
     ret = IAMF_ERR_ALLOC_FAIL;
     goto stream_enable_fail;
   }
+  iamf_stream_scale_demixer_set_demand(decoder, renderer);
 
   streams = IAMF_REALLOC(IAMF_Stream *, pst->streams, pst->nb_streams + 1);
   if (!streams) goto stream_enable_fail;
@@ -1937,6 +2080,9 @@ static IAMF_CoreDecoder *iamf_stream_sub_decoder_open(
                                        nb_coupled_streams, mapping,
                                        mapping_size);
     ret = iamf_core_decoder_init(cDecoder);
+    if (ret == IAMF_OK)
+      ret = iamf_core_decoder_set_frame_size(cDecoder,
+                                             conf->nb_samples_per_frame);
     if (ret != IAMF_OK) {
       ia_loge("Fail to initalize core decoder.");
       iamf_core_decoder_close(cDecoder);
@@ -1949,14 +2095,48 @@ static IAMF_CoreDecoder *iamf_stream_sub_decoder_open(
 
 static int iamf_stream_decoder_decode_finish(IAMF_StreamDecoder *decoder);
 
+/**
+ * The sub packets refer to the data of the caller until the temporal unit is
+ * decoded. If the decoding call returns before that, the sub packets must be
+ * copied to the packet buffer, which is only reallocated for a bigger packet.
+ * */
+static int iamf_packet_hold(Packet *pkt) {
+  uint32_t size = pkt->buffer_size;
+  uint8_t *buffer = pkt->buffer;
+  uint8_t *sp;
+
+  for (int i = 0; i < pkt->nb_sub_packets; ++i) {
+    if (pkt->sub_packets[i] && pkt->sub_packet_sizes[i] > size)
+      size = pkt->sub_packet_sizes[i];
+  }
+
+  if (size > pkt->buffer_size) {
+    ia_logd("sub packet buffer size %u -> %u", pkt->buffer_size, size);
+    buffer = IAMF_MALLOC(uint8_t, size * pkt->nb_sub_packets);
+    if (!buffer) return IAMF_ERR_ALLOC_FAIL;
+  }
+
+  for (int i = 0; i < pkt->nb_sub_packets; ++i) {
+    sp = pkt->sub_packets[i];
+    if (!sp || (buffer == pkt->buffer && sp == buffer + i * size)) continue;
+    memcpy(buffer + i * size, sp, pkt->sub_packet_sizes[i]);
+    pkt->sub_packets[i] = buffer + i * size;
+  }
+
+  if (buffer != pkt->buffer) {
+    IAMF_FREE(pkt->buffer);
+    pkt->buffer = buffer;
+    pkt->buffer_size = size;
+  }
+
+  return IAMF_OK;
+}
+
 void iamf_stream_decoder_close(IAMF_StreamDecoder *d) {
   if (d) {
     IAMF_Stream *s = d->stream;
 
-    if (d->packet.sub_packets) {
-      for (int i = 0; i < d->packet.nb_sub_packets; ++i)
-        IAMF_FREE(d->packet.sub_packets[i]);
-    }
+    IAMF_FREE(d->packet.buffer);
     IAMF_FREE(d->packet.sub_packets);
     IAMF_FREE(d->packet.sub_packet_sizes);
 
@@ -2031,7 +2211,13 @@ IAMF_StreamDecoder *iamf_stream_decoder_open(IAMF_Stream *stream,
   decoder->packet.sub_packet_sizes =
       IAMF_MALLOCZ(uint32_t, stream->nb_substreams);
 
-  if (!decoder->packet.sub_packets || !decoder->packet.sub_packet_sizes)
+  decoder->packet.buffer_size =
+      decoder->frame_size * SUB_PACKET_BYTES_PER_SAMPLE;
+  decoder->packet.buffer = IAMF_MALLOC(
+      uint8_t, decoder->packet.buffer_size * stream->nb_substreams);
+
+  if (!decoder->packet.sub_packets || !decoder->packet.sub_packet_sizes ||
+      !decoder->packet.buffer)
     goto open_fail;
 
   ia_logt("check channels.");
@@ -2102,21 +2288,19 @@ open_fail:
   return 0;
 }
 
+/* returns 1 if the packet of the substream is received for the first time. */
 static int iamf_stream_decoder_receive_packet(IAMF_StreamDecoder *decoder,
                                               int substream_index,
                                               IAMF_Frame *packet) {
+  int ret = 0;
+
   if (substream_index > INVALID_VALUE &&
       substream_index < decoder->packet.nb_sub_packets) {
     if (!decoder->packet.sub_packets[substream_index]) {
       ++decoder->packet.count;
+      ret = 1;
     }
-    IAMF_FREE(decoder->packet.sub_packets[substream_index]);
-    decoder->packet.sub_packets[substream_index] =
-        IAMF_MALLOC(uint8_t, packet->size);
-    if (!decoder->packet.sub_packets[substream_index])
-      return IAMF_ERR_ALLOC_FAIL;
-    memcpy(decoder->packet.sub_packets[substream_index], packet->data,
-           packet->size);
+    decoder->packet.sub_packets[substream_index] = packet->data;
     decoder->packet.sub_packet_sizes[substream_index] = packet->size;
   }
 
@@ -2125,7 +2309,7 @@ static int iamf_stream_decoder_receive_packet(IAMF_StreamDecoder *decoder,
     decoder->frame.etrim = packet->trim_end;
   }
 
-  return 0;
+  return ret;
 }
 
 static int iamf_stream_decoder_update_parameter(IAMF_StreamDecoder *dec,
@@ -2190,9 +2374,8 @@ static int iamf_stream_decoder_decode(IAMF_StreamDecoder *decoder, float *pcm) {
 }
 
 int iamf_stream_decoder_decode_finish(IAMF_StreamDecoder *decoder) {
-  for (int i = 0; i < decoder->packet.nb_sub_packets; ++i) {
-    IAMF_FREEP(&decoder->packet.sub_packets[i]);
-  }
+  memset(decoder->packet.sub_packets, 0,
+         sizeof(uint8_t *) * decoder->packet.nb_sub_packets);
   memset(decoder->packet.sub_packet_sizes, 0,
          sizeof(uint32_t) * decoder->packet.nb_sub_packets);
   decoder->packet.count = 0;
@@ -2303,7 +2486,8 @@ static int iamf_stream_scale_decoder_decode(IAMF_StreamDecoder *decoder,
     ret = iamf_core_decoder_decode(
         dec, &decoder->packet.sub_packets[substream_offset],
         &decoder->packet.sub_packet_sizes[substream_offset],
-        ctx->conf_s[i].nb_substreams, out, decoder->frame_size);
+        ctx->conf_s[i].nb_substreams, out, decoder->frame_size,
+        decoder->pool);
     if (ret < 0) {
       ia_loge("sub packet %d decode fail.", i);
       break;
@@ -2348,6 +2532,16 @@ static int32_t iamf_stream_scale_decoder_demix(IAMF_StreamDecoder *decoder,
   return demixer_demixing(scale->demixer, dst, src, frame_size);
 }
 
+/* only demixes the channels which are read by the renderer. */
+static void iamf_stream_scale_demixer_set_demand(IAMF_StreamDecoder *decoder,
+                                                 IAMF_StreamRenderer *sr) {
+  if (decoder->stream->scheme != AUDIO_ELEMENT_TYPE_CHANNEL_BASED ||
+      !decoder->scale->demixer || !sr)
+    return;
+  demixer_set_output_mask(decoder->scale->demixer,
+                          iamf_stream_renderer_input_mask(sr));
+}
+
 int iamf_stream_scale_demixer_configure(IAMF_StreamDecoder *decoder) {
   IAMF_Stream *stream = decoder->stream;
   ScalableChannelDecoder *scale = decoder->scale;
@@ -2423,9 +2617,10 @@ int iamf_stream_ambisonics_decoder_decode(IAMF_StreamDecoder *decoder,
     ia_logd(" > sub-packet %d (%p) size %d", k, decoder->packet.sub_packets[k],
             decoder->packet.sub_packet_sizes[k]);
   }
-  ret = iamf_core_decoder_decode(
-      dec, decoder->packet.sub_packets, decoder->packet.sub_packet_sizes,
-      decoder->packet.nb_sub_packets, pcm, decoder->frame_size);
+  ret = iamf_core_decoder_decode(dec, decoder->packet.sub_packets,
+                                 decoder->packet.sub_packet_sizes,
+                                 decoder->packet.nb_sub_packets, pcm,
+                                 decoder->frame_size, decoder->pool);
   if (ret < 0) {
     ia_loge("ambisonics stream packet decode fail.");
   } else if (ret != decoder->frame_size) {
@@ -2477,16 +2672,88 @@ int iamf_stream_renderer_enable_downmix(IAMF_StreamRenderer *sr) {
   return IAMF_OK;
 }
 
+/* resolves the rendering matrix, the layouts are fixed until reopening. */
+static void iamf_stream_renderer_init_matrix(IAMF_StreamRenderer *sr) {
+  IAMF_Stream *s = sr->stream;
+  IAMF_SP_LAYOUT *out = &s->final_layout->sp;
+  int ret = -1;
+
+#if DISABLE_BINAURALIZER == 0
+  if (s->final_layout->layout.type == IAMF_LAYOUT_TYPE_BINAURAL &&
+      s->scheme == AUDIO_ELEMENT_TYPE_SCENE_BASED)
+    return;
+#endif
+
+  if (s->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED) {
+    ChannelLayerContext *ctx = (ChannelLayerContext *)s->priv;
+    IAMF_SP_LAYOUT lin;
+    IAMF_PREDEFINED_SP_LAYOUT pin;
+
+    memset(&lin, 0, sizeof(IAMF_SP_LAYOUT));
+    memset(&pin, 0, sizeof(IAMF_PREDEFINED_SP_LAYOUT));
+
+    lin.sp_layout.predefined_sp = &pin;
+    if (s->nb_channels == 1) {
+      pin.system = IAMF_MONO;
+    } else {
+      pin.system = iamf_layer_layout_get_rendering_id(ctx->layout);
+      pin.lfe1 = iamf_layer_layout_lfe1(ctx->layout);
+    }
+
+    ret = IAMF_element_renderer_get_M2M_matrix(&lin, out, &sr->renderer.mr);
+    if (!ret) {
+      struct m2m_rdr_t *mr = &sr->renderer.mr;
+      sr->renderer.sparse =
+          IAMF_element_renderer_sparse_open(mr->mat, mr->n, 1, mr->m, mr->n);
+    }
+  } else if (s->scheme == AUDIO_ELEMENT_TYPE_SCENE_BASED) {
+    IAMF_HOA_LAYOUT hin;
+
+    hin.order = iamf_stream_ambisionisc_order(s->nb_channels);
+    ia_logd("ambisonics order is %d", hin.order);
+#if DISABLE_LFE_HOA == 1
+    hin.lfe_on = 0;
+#else
+    hin.lfe_on = 1;
+#endif
+    if (hin.order != UINT32_MAX)
+      ret = IAMF_element_renderer_get_H2M_matrix(
+          &hin, out->sp_layout.predefined_sp, &sr->renderer.hr);
+    if (!ret) {
+      struct h2m_rdr_t *hr = &sr->renderer.hr;
+      sr->renderer.sparse =
+          IAMF_element_renderer_sparse_open(hr->mat, 1, hr->m, hr->m, hr->n);
+    }
+  }
+
+  if (ret < 0) {
+    // clears the matrices of both renderers in the union.
+    memset(&sr->renderer.hr, 0, sizeof(sr->renderer.hr));
+    ia_logw("no rendering matrix for element %" PRIu64, s->element_id);
+  }
+}
+
 IAMF_StreamRenderer *iamf_stream_renderer_open(IAMF_Stream *s,
                                                IAMF_MixPresentation *mp,
                                                int frame_size) {
   ChannelLayerContext *ctx = (ChannelLayerContext *)s->priv;
   IAMF_StreamRenderer *sr = IAMF_MALLOCZ(IAMF_StreamRenderer, 1);
-  if (!sr) 0;
+  int inchs = s->nb_channels;
+  if (!sr) return 0;
 
   sr->stream = s;
+  if (s->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED)
+    inchs = IA_CH_LAYOUT_MAX_CHANNELS;
+  sr->sin = IAMF_MALLOCZ(float *, inchs);
+  sr->sout = IAMF_MALLOCZ(float *, s->final_layout->channels);
+  if (!sr->sin || !sr->sout) {
+    iamf_stream_renderer_close(sr);
+    return 0;
+  }
+
   iamf_stream_renderer_enable_downmix(sr);
   iamf_stream_renderer_update_info(sr, mp, frame_size);
+  if (!sr->downmixer) iamf_stream_renderer_init_matrix(sr);
 
 #if DISABLE_BINAURALIZER == 0
   if (s->final_layout) {
@@ -2530,36 +2797,73 @@ void iamf_stream_renderer_close(IAMF_StreamRenderer *sr) {
   }
 #endif
 
+  IAMF_element_renderer_sparse_close(sr->renderer.sparse);
+
+  IAMF_FREE(sr->sin);
+  IAMF_FREE(sr->sout);
   free(sr);
 }
 
-static int iamf_stream_render(IAMF_StreamRenderer *sr, float *in, float *out,
-                              int frame_size) {
+/* the mask of the decoded channels which are read by the renderer. */
+static uint32_t iamf_stream_renderer_input_mask(IAMF_StreamRenderer *sr) {
   IAMF_Stream *stream = sr->stream;
-  int ret = IAMF_OK;
-  int inchs;
-  int outchs = stream->final_layout->channels;
-  float **sout = IAMF_MALLOCZ(float *, outchs);
-  float **sin = 0;
-  lfe_filter_t *plfe = 0;
+  struct rdr_sparse_t *sparse;
+  uint32_t mask = 0;
 
-  if (!sout) {
-    ret = IAMF_ERR_ALLOC_FAIL;
-    goto render_end;
-  }
-  for (int i = 0; i < outchs; ++i) sout[i] = &out[frame_size * i];
+#if SR
+  return UINT32_MAX;
+#endif
+  if (stream->scheme != AUDIO_ELEMENT_TYPE_CHANNEL_BASED) return UINT32_MAX;
+#if DISABLE_BINAURALIZER == 0
+  if (stream->final_layout->layout.type == IAMF_LAYOUT_TYPE_BINAURAL &&
+      sr->headphones_rendering_mode == 1)
+    return UINT32_MAX;
+#endif
+  if (sr->downmixer) return DMRenderer_get_input_mask(sr->downmixer);
+
+  sparse = sr->renderer.sparse;
+  if (!sparse) return UINT32_MAX;
+
+  for (int i = 0; i < sparse->offsets[sr->renderer.mr.n]; ++i)
+    mask |= RSHIFT(sparse->taps[i].input);
+  return mask;
+}
+
+static void iamf_stream_renderer_set_input(IAMF_StreamRenderer *sr,
+                                           float *in, int frame_size) {
+  IAMF_Stream *stream = sr->stream;
+  int inchs = stream->nb_channels;
 
-  inchs = stream->nb_channels;
   if (stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED) {
     ChannelLayerContext *ctx = (ChannelLayerContext *)stream->priv;
     inchs = ia_channel_layout_get_channels_count(ctx->layout);
   }
-  sin = IAMF_MALLOCZ(float *, inchs);
-  if (!sin) {
-    ret = IAMF_ERR_ALLOC_FAIL;
-    goto render_end;
+  for (int i = 0; i < inchs; ++i) sr->sin[i] = &in[frame_size * i];
+}
+
+static lfe_filter_t *iamf_stream_renderer_get_lfe(IAMF_StreamRenderer *sr) {
+  lfe_filter_t *plfe = 0;
+#if DISABLE_LFE_HOA == 0
+  IAMF_Stream *stream = sr->stream;
+
+  if (iamf_layout_lfe_check(&stream->final_layout->layout)) {
+    plfe = &stream->final_layout->sp.lfe_f;
+    if (plfe->init == 0) lfefilter_init(plfe, 120, stream->sampling_rate);
   }
-  for (int i = 0; i < inchs; ++i) sin[i] = &in[frame_size * i];
+#endif
+  return plfe;
+}
+
+static int iamf_stream_render(IAMF_StreamRenderer *sr, float *in, float *out,
+                              int frame_size) {
+  IAMF_Stream *stream = sr->stream;
+  int ret = IAMF_OK;
+  int outchs = stream->final_layout->channels;
+  float **sout = sr->sout;
+  float **sin = sr->sin;
+
+  for (int i = 0; i < outchs; ++i) sout[i] = &out[frame_size * i];
+  iamf_stream_renderer_set_input(sr, in, frame_size);
 
   if (stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED) {
 #if DISABLE_BINAURALIZER == 0
@@ -2582,25 +2886,12 @@ static int iamf_stream_render(IAMF_StreamRenderer *sr, float *in, float *out,
         DMRenderer_downmix(sr->downmixer, in, out, sr->offset,
                            frame_size - sr->offset, frame_size);
     } else {
-      ChannelLayerContext *ctx = (ChannelLayerContext *)stream->priv;
-      struct m2m_rdr_t m2m;
-      IAMF_SP_LAYOUT lin;
-      IAMF_PREDEFINED_SP_LAYOUT pin;
-
-      memset(&lin, 0, sizeof(IAMF_SP_LAYOUT));
-      memset(&pin, 0, sizeof(IAMF_PREDEFINED_SP_LAYOUT));
-
-      lin.sp_layout.predefined_sp = &pin;
-      if (stream->nb_channels == 1) {
-        pin.system = IAMF_MONO;
-      } else {
-        pin.system = iamf_layer_layout_get_rendering_id(ctx->layout);
-        pin.lfe1 = iamf_layer_layout_lfe1(ctx->layout);
+      if (!sr->renderer.mr.mat) {
+        memset(out, 0, sizeof(float) * frame_size * outchs);
+        return IAMF_ERR_INTERNAL;
       }
-
-      IAMF_element_renderer_get_M2M_matrix(&lin, &stream->final_layout->sp,
-                                           &m2m);
-      IAMF_element_renderer_render_M2M(&m2m, sin, sout, frame_size);
+      IAMF_element_renderer_render_M2M(&sr->renderer.mr, sr->renderer.sparse,
+                                       sin, sout, frame_size);
     }
   } else if (stream->scheme == AUDIO_ELEMENT_TYPE_SCENE_BASED) {
 #if DISABLE_BINAURALIZER == 0
@@ -2610,44 +2901,89 @@ static int iamf_stream_render(IAMF_StreamRenderer *sr, float *in, float *out,
                                        frame_size);
     } else {
 #endif
-      struct h2m_rdr_t h2m;
-      IAMF_HOA_LAYOUT hin;
-      hin.order = iamf_stream_ambisionisc_order(inchs);
-      ia_logd("ambisonics order is %d", hin.order);
-      if (hin.order == UINT32_MAX) {
+      if (!sr->renderer.hr.mat) {
+        memset(out, 0, sizeof(float) * frame_size * outchs);
         ret = IAMF_ERR_INTERNAL;
         goto render_end;
       }
-#if DISABLE_LFE_HOA == 1
-      hin.lfe_on = 0;
-      IAMF_element_renderer_get_H2M_matrix(
-          &hin, stream->final_layout->sp.sp_layout.predefined_sp, &h2m);
-#else
-    hin.lfe_on = 1;
-    IAMF_element_renderer_get_H2M_matrix(
-        &hin, stream->final_layout->sp.sp_layout.predefined_sp, &h2m);
 
-    if (hin.lfe_on && iamf_layout_lfe_check(&stream->final_layout->layout)) {
-      plfe = &stream->final_layout->sp.lfe_f;
-      if (plfe->init == 0) lfefilter_init(plfe, 120, stream->sampling_rate);
-    }
-#endif
-
-      IAMF_element_renderer_render_H2M(&h2m, sin, sout, frame_size, plfe);
+      IAMF_element_renderer_render_H2M(&sr->renderer.hr, sr->renderer.sparse,
+                                       sin, sout, frame_size,
+                                       iamf_stream_renderer_get_lfe(sr));
 #if DISABLE_BINAURALIZER == 0
     }
 #endif
   }
 
 render_end:
+  return ret;
+}
+
+/* the stream is rendered by the compiled matrix to all output channels. */
+static int iamf_stream_renderer_mixable(IAMF_StreamRenderer *sr) {
+  IAMF_Stream *stream = sr->stream;
+  struct h2m_rdr_t *hr = &sr->renderer.hr;
+  int outchs = stream->final_layout->channels;
+
+#if SR
+  return 0;
+#endif
+  if (!sr->renderer.sparse) return 0;
+#if DISABLE_BINAURALIZER == 0
+  if (stream->final_layout->layout.type == IAMF_LAYOUT_TYPE_BINAURAL &&
+      (stream->scheme == AUDIO_ELEMENT_TYPE_SCENE_BASED ||
+       sr->headphones_rendering_mode == 1))
+    return 0;
+#endif
+  if (stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED)
+    return !sr->downmixer && sr->renderer.mr.n == outchs;
+  return hr->n + (hr->lfe1 >= 0) + (hr->lfe2 >= 0) == outchs;
+}
+
+/**
+ * Renders the stream into the mixed frame channel by channel. Every channel is
+ * scaled by the element mix gain and stored or accumulated to the mixed frame
+ * while it is in cache, the sums and products are the ones of rendering and
+ * mixing one after the other.
+ * */
+static void iamf_stream_render_mix(IAMF_StreamRenderer *sr, float *in,
+                                   float *mix, float *buffer, int frame_size,
+                                   MixGainUnit *gain, int first) {
+  IAMF_Stream *stream = sr->stream;
+  struct rdr_sparse_t *sparse = sr->renderer.sparse;
+  struct h2m_rdr_t *hr = &sr->renderer.hr;
+  float **sin = sr->sin;
+  int ch;
 
-  if (sin) {
-    free(sin);
+  iamf_stream_renderer_set_input(sr, in, frame_size);
+
+  if (stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED) {
+    for (int n = 0; n < sr->renderer.mr.n; ++n) {
+      IAMF_element_renderer_render_sparse_channel(sparse, sin, n, buffer,
+                                                  frame_size);
+      iamf_mix_gain_apply(gain, mix + n * frame_size, buffer, frame_size, 1,
+                          !first);
+    }
+    return;
   }
-  if (sout) {
-    free(sout);
+
+  if (hr->lfe1 >= 0 || hr->lfe2 >= 0) {
+    IAMF_element_renderer_render_H2M_lfe(hr, sin, buffer, frame_size,
+                                         iamf_stream_renderer_get_lfe(sr));
+    if (hr->lfe1 >= 0)
+      iamf_mix_gain_apply(gain, mix + hr->lfe1 * frame_size, buffer,
+                          frame_size, 1, !first);
+    if (hr->lfe2 >= 0)
+      iamf_mix_gain_apply(gain, mix + hr->lfe2 * frame_size, buffer,
+                          frame_size, 1, !first);
+  }
+  for (int n = 0; n < hr->n; ++n) {
+    IAMF_element_renderer_render_sparse_channel(sparse, sin, n, buffer,
+                                                frame_size);
+    ch = IAMF_element_renderer_get_H2M_channel(hr, n);
+    iamf_mix_gain_apply(gain, mix + ch * frame_size, buffer, frame_size, 1,
+                        !first);
   }
-  return ret;
 }
 
 void iamf_mixer_reset(IAMF_Mixer *m) {
@@ -2699,11 +3035,22 @@ static int iamf_mixer_add_frame(IAMF_Mixer *mixer, Frame *f) {
   return IAMF_OK;
 }
 
-static int iamf_mixer_mix(IAMF_Mixer *mixer, Frame *f) {
+/**
+ * Accumulates the frame scaled by its element mix gain into the mixed data, or
+ * stores it for the first frame. The products are the same as the ones of
+ * iamf_frame_gain.
+ * */
+static void iamf_mixer_add_gained(float *mix, Frame *f, int samples, int chs,
+                                  int first) {
+  iamf_mix_gain_apply(iamf_mix_gain_check(f->gain, samples), mix, f->data,
+                      samples, chs, !first);
+}
+
+/* the first mixed elements have been rendered into the mixed data. */
+static int iamf_mixer_mix(IAMF_Mixer *mixer, Frame *f, int mixed) {
   int s = mixer->frames[0]->samples;
   int64_t pts = mixer->frames[0]->pts;
   int chs = mixer->frames[0]->channels;
-  int soff;
 
   for (int i = 1; i < mixer->nb_elements; ++i) {
     if (s != mixer->frames[i]->samples || pts != mixer->frames[i]->pts) {
@@ -2718,16 +3065,9 @@ static int iamf_mixer_mix(IAMF_Mixer *mixer, Frame *f) {
   f->samples = s;
   f->strim = mixer->frames[0]->strim;
   ia_logd("mixed frame pts %" PRId64 ", samples %d", f->pts, s);
-  memset(f->data, 0, sizeof(float) * s * chs);
 
-  for (int e = 0; e < mixer->nb_elements; ++e) {
-    for (int c = 0; c < chs; ++c) {
-      soff = c * f->samples;
-      for (int i = 0; i < f->samples; ++i) {
-        f->data[soff + i] += mixer->frames[e]->data[soff + i];
-      }
-    }
-  }
+  for (int e = mixed; e < mixer->nb_elements; ++e)
+    iamf_mixer_add_gained(f->data, mixer->frames[e], s, chs, !e);
 
   return s;
 }
@@ -2745,6 +3085,7 @@ static int32_t iamf_decoder_internal_reset(IAMF_DecoderHandle handle) {
   if (ctx->output_layout) iamf_layout_info_free(ctx->output_layout);
   memset(ctx, 0, sizeof(IAMF_DecoderContext));
   if (handle->limiter) audio_effect_peak_limiter_uninit(handle->limiter);
+  handle->pipeline.samples = 0;
 
   return 0;
 }
@@ -2851,17 +3192,16 @@ static uint32_t iamf_decoder_internal_parameter_prepare(
   return IAMF_OK;
 }
 
+static void iamf_presentation_count_pending(IAMF_Presentation *pst) {
+  pst->nb_pending = 0;
+  for (int s = 0; s < pst->nb_streams; ++s)
+    pst->nb_pending += pst->decoders[s]->packet.nb_sub_packets -
+                       pst->decoders[s]->packet.count;
+}
+
 static int iamf_decoder_internal_update_statue(IAMF_DecoderHandle handle) {
   IAMF_DecoderContext *ctx = &handle->ctx;
-  IAMF_Presentation *pst = ctx->presentation;
-  int ret = 1;
-
-  for (int s = 0; s < pst->nb_streams; ++s) {
-    if (!iamf_packet_check_count(&pst->decoders[s]->packet)) {
-      ret &= 0;
-      break;
-    }
-  }
+  int ret = ctx->presentation->nb_pending <= 0;
 
   if (ret) ctx->status = IAMF_DECODER_STATUS_RUN;
 
@@ -2883,13 +3223,17 @@ uint32_t iamf_decoder_internal_parse_OBUs(IAMF_DecoderHandle handle,
     if (obu.type == IAMF_OBU_PARAMETER_BLOCK) {
       uint64_t pid = IAMF_OBU_get_object_id(&obu);
       if (pid != INVALID_ID) {
+        IAMF_DataBase *db = &handle->ctx.db;
+        IAMF_Parameter *param = &db->param;
+        ParameterItem *pi =
+            iamf_database_parameter_viewer_get_item(&db->pViewer, pid);
         IAMF_ParameterParam ext;
         memset(&ext, 0, sizeof(IAMF_ParameterParam));
-        IAMF_ObjectParameter *param = IAMF_OBJECT_PARAM(&ext);
-        IAMF_Object *obj;
         ext.base.type = IAMF_OBU_PARAMETER_BLOCK;
-        ext.param_base = iamf_database_parameter_viewer_get_parmeter_base(
-            &handle->ctx.db, pid);
+        if (pi) {
+          ext.param_base = pi->param_base;
+          ext.pool = &pi->pool;
+        }
         IAMF_Element *e = IAMF_ELEMENT(
             iamf_database_get_element_by_parameterID(&handle->ctx.db, pid));
         if (e) {
@@ -2904,16 +3248,17 @@ uint32_t iamf_decoder_internal_parse_OBUs(IAMF_DecoderHandle handle,
             }
           }
         }
-        obj = IAMF_object_new(&obu, param);
-        iamf_database_add_object(&handle->ctx.db, obj);
+        // the segments are moved into the database, or reused later.
+        if (IAMF_parameter_init(param, &obu, &ext) == IAMF_OK)
+          iamf_database_parameter_add(db, IAMF_OBJ(param));
+        IAMF_parameter_reset(param, ext.pool);
         iamf_decoder_internal_parameter_prepare(handle, pid);
       }
     } else if (obu.type >= IAMF_OBU_AUDIO_FRAME &&
                obu.type <= IAMF_OBU_AUDIO_FRAME_ID17) {
-      IAMF_Object *obj = IAMF_object_new(&obu, 0);
-      IAMF_Frame *o = (IAMF_Frame *)obj;
-      iamf_decoder_internal_deliver(handle, o);
-      IAMF_object_free(obj);
+      IAMF_Frame frame;
+      IAMF_frame_init(&frame, &obu);
+      iamf_decoder_internal_deliver(handle, &frame);
       iamf_decoder_internal_update_statue(handle);
     } else if (obu.type == IAMF_OBU_SEQUENCE_HEADER && !obu.redundant) {
       ia_logi("*********** FOUND NEW MAGIC CODE **********");
@@ -2945,18 +3290,15 @@ int32_t iamf_decoder_internal_add_descrptor_OBU(IAMF_DecoderHandle handle,
 
 int iamf_decoder_internal_deliver(IAMF_DecoderHandle handle, IAMF_Frame *obj) {
   IAMF_DecoderContext *ctx = &handle->ctx;
-  IAMF_DataBase *db = &ctx->db;
   IAMF_Presentation *pst = ctx->presentation;
+  SubstreamRoute *route = iamf_presentation_get_route(pst, obj->id);
   int idx = -1, i;
   IAMF_Stream *stream;
   IAMF_StreamDecoder *decoder;
 
-  for (i = 0; i < pst->nb_streams; ++i) {
-    idx = iamf_database_element_get_substream_index(
-        db, pst->streams[i]->element_id, obj->id);
-    if (idx > -1) {
-      break;
-    }
+  if (route) {
+    i = route->stream;
+    idx = route->index;
   }
 
   if (idx > -1) {
@@ -2988,7 +3330,8 @@ int iamf_decoder_internal_deliver(IAMF_DecoderHandle handle, IAMF_Frame *obj) {
       }
 #endif
     }
-    iamf_stream_decoder_receive_packet(decoder, idx, obj);
+    if (iamf_stream_decoder_receive_packet(decoder, idx, obj) > 0)
+      --pst->nb_pending;
   }
 
   return 0;
@@ -3198,6 +3541,22 @@ static int iamf_decoder_enable_mix_presentation(IAMF_DecoderHandle handle,
   }
   pst->resampler = resampler;
 
+  if (iamf_presentation_arena_init(pst, ctx->info.max_frame_size) != IAMF_OK ||
+      iamf_presentation_route_substreams(pst, db) != IAMF_OK)
+    return IAMF_ERR_ALLOC_FAIL;
+  iamf_presentation_count_pending(pst);
+
+  ctx->info.pipeline_latency = 0;
+  ctx->info.max_output_size = ctx->info.max_frame_size;
+  if (handle->pipeline.enable) {
+    // the flush outputs the pending frame with the delay signal.
+    ctx->info.max_output_size *= 2;
+    ctx->info.pipeline_latency = (uint64_t)pst->decoders[0]->frame_size *
+                                 ctx->sampling_rate / stream->sampling_rate;
+    if (iamf_decoder_pipeline_prepare(handle) != IAMF_OK)
+      return IAMF_ERR_ALLOC_FAIL;
+  }
+
   if (old) iamf_presentation_free(old);
 
   return IAMF_OK;
@@ -3232,7 +3591,7 @@ static int iamf_resample(SpeexResamplerState *resampler, float *in, float *out,
         resampler, (const float *)NULL, (uint32_t *)&input_size, (float *)in,
         (uint32_t *)&resample_size);
   } else {
-    ia_decoder_plane2stride_out_float(resampler->buffer, in, frame_size,
+    sample_convert_plane2stride_float(resampler->buffer, in, frame_size,
                                       resampler->nb_channels);
     speex_resampler_process_interleaved_float(
         resampler, (const float *)resampler->buffer, (uint32_t *)&frame_size,
@@ -3241,13 +3600,48 @@ static int iamf_resample(SpeexResamplerState *resampler, float *in, float *out,
   if (!resampler->rest_flag) {
     resampler->rest_flag = 1;
   }
-  ia_decoder_stride2plane_out_float(out, in, resample_size,
+  sample_convert_stride2plane_float(out, in, resample_size,
                                     resampler->nb_channels);
   ia_logt("read samples %d, output samples %d", frame_size, resample_size);
   return resample_size;
 }
 
-static int iamf_delay_buffer_handle(IAMF_DecoderHandle handle, void *pcm) {
+static void iamf_decoder_output(IAMF_DecoderHandle handle, const float *in,
+                                int frame_size) {
+  IAMF_DecoderContext *ctx = &handle->ctx;
+  IAMF_Output *o = &handle->output;
+  int channels = ctx->output_layout->channels;
+
+  if (frame_size <= 0) return;
+
+  if (o->channels && o->interleaved) {
+    sample_convert_plane2stride_float(o->channels[0] + o->offset * channels,
+                                      in, frame_size, channels);
+  } else if (o->channels) {
+    for (int c = 0; c < channels; ++c) {
+      if (in)
+        memcpy(o->channels[c] + o->offset, in + c * frame_size,
+               sizeof(float) * frame_size);
+      else
+        memset(o->channels[c] + o->offset, 0, sizeof(float) * frame_size);
+    }
+  } else {
+#ifdef SAMSUNG_TV
+    sample_convert_plane2stride(
+        (char *)o->pcm +
+            ctx->bit_depth / 8 * o->offset * SAMSUNG_SPECIFIC_CHANNELS,
+        in, frame_size, channels, ctx->bit_depth, SAMSUNG_SPECIFIC_CHANNELS);
+#else
+    sample_convert_plane2stride(
+        (char *)o->pcm + ctx->bit_depth / 8 * o->offset * channels, in,
+        frame_size, channels, ctx->bit_depth, channels);
+#endif
+  }
+
+  o->offset += frame_size;
+}
+
+static int iamf_delay_buffer_handle(IAMF_DecoderHandle handle) {
   IAMF_DecoderContext *ctx = &handle->ctx;
   IAMF_Presentation *pst = ctx->presentation;
   SpeexResamplerState *resampler = pst->resampler;
@@ -3259,14 +3653,10 @@ static int iamf_delay_buffer_handle(IAMF_DecoderHandle handle, void *pcm) {
   if (!limiter && (!resampler || resampler->in_rate == resampler->out_rate))
     return 0;
 
-  in = IAMF_MALLOCZ(float, buffer_size);
-  out = IAMF_MALLOCZ(float, buffer_size);
-
-  if (!in || !out) {
-    if (in) free(in);
-    if (out) free(out);
-    return IAMF_ERR_ALLOC_FAIL;
-  }
+  in = pst->buffers[0];
+  out = pst->buffers[1];
+  memset(in, 0, sizeof(float) * buffer_size);
+  memset(out, 0, sizeof(float) * buffer_size);
 
   if (resampler) {
     pst->resampler->rest_flag = 2;
@@ -3286,238 +3676,393 @@ static int iamf_delay_buffer_handle(IAMF_DecoderHandle handle, void *pcm) {
         audio_effect_peak_limiter_process_block(limiter, in, out, frame_size);
   }
 
-#ifdef SAMSUNG_TV
-  iamf_decoder_plane2stride_out(pcm, out, frame_size,
-                                ctx->output_layout->channels, ctx->bit_depth,
-                                SAMSUNG_SPECIFIC_CHANNELS);
-#else
-  iamf_decoder_plane2stride_out(pcm, out, frame_size,
-                                ctx->output_layout->channels, ctx->bit_depth,
-                                ctx->output_layout->channels);
-#endif
-  free(in);
-  free(out);
+  iamf_decoder_output(handle, out, frame_size);
   return frame_size;
 }
 
-static int iamf_decoder_internal_decode(IAMF_DecoderHandle handle,
-                                        const uint8_t *data, int32_t size,
-                                        uint32_t *rsize, void *pcm) {
+static MixGainUnit *iamf_decoder_stream_gain(IAMF_DecoderHandle handle,
+                                             int s) {
+  IAMF_DataBase *db = &handle->ctx.db;
+  IAMF_Presentation *pst = handle->ctx.presentation;
+  IAMF_Stream *stream = pst->streams[s];
+  Frame *f = &pst->decoders[s]->frame;
+  ElementItem *ei = iamf_database_element_get_item(db, stream->element_id);
+
+  if (!ei || !ei->mixGain) return 0;
+  return iamf_database_parameter_get_mix_gain_unit(
+      db, ei->mixGain->id, f->pts, f->samples, stream->sampling_rate,
+      &pst->tasks[s].gain);
+}
+
+/**
+ * Decodes, renders, trims and applies the element mix gain of one stream. The
+ * stream is rendered into the mixed frame with its mix gain if the mixed frame
+ * is given and the streams before it have been mixed, otherwise its frame is
+ * mixed by the mixer.
+ * */
+static void iamf_decoder_stream_task(void *arg, int s) {
+  IAMF_DecoderHandle handle = (IAMF_DecoderHandle)arg;
+  IAMF_DecoderContext *ctx = &handle->ctx;
+  IAMF_Presentation *pst = ctx->presentation;
+  IAMF_StreamTask *task = &pst->tasks[s];
+  IAMF_StreamRenderer *renderer = pst->renderers[s];
+  IAMF_StreamDecoder *decoder = pst->decoders[s];
+  IAMF_Stream *stream = decoder->stream;
+  Frame *f = &decoder->frame;
+  float *out = decoder->buffers[1];
+  int ret;
+
+  f->data = decoder->buffers[0];
+  f->gain = 0;
+  task->mixed = 0;
+  f->pts = stream->timestamp;
+#if !SR
+  // the substreams of the stream are decoded on the same pool.
+  decoder->pool = handle->pool;
+#endif
+  if (decoder->delay > 0) f->pts -= decoder->delay;
+
+  ret = iamf_stream_decoder_decode(decoder, f->data);
+  iamf_stream_decoder_decode_finish(decoder);
+
+  if (ret > 0) {
+    ia_logd("strim %" PRIu64 ", etrim %" PRIu64
+            ", frame size %u, delay size %d",
+            f->strim, f->etrim, decoder->frame_size, decoder->delay);
+    if (f->strim == decoder->frame_size ||
+        f->etrim == decoder->frame_size) {
+      ret = 0;
+      ia_logd("The whole frame which size is %d has been cut.", f->samples);
+    } else {
+      f->samples = ret;
+
+#if SR
+      // decoding
+      iamf_rec_stream_log(stream->element_id, f->channels, f->data, ret);
+#endif
+
+      if (decoder->frame_padding > 0) {
+        ia_logw("decoded result is %d, different frame size %d",
+                ret - decoder->frame_padding, decoder->frame_size);
+        f->etrim += decoder->frame_padding;
+      }
+
+      f->channels = ctx->output_layout->channels;
+      if (task->mix && (!s || pst->tasks[s - 1].mixed) && !task->flush &&
+          !f->strim && !f->etrim && !stream->trimming_start &&
+          iamf_stream_renderer_mixable(renderer)) {
+        f->samples = ret;
+        f->gain = iamf_mix_gain_check(iamf_decoder_stream_gain(handle, s), ret);
+        iamf_stream_render_mix(renderer, f->data, task->mix, out, ret, f->gain,
+                               !s);
+        task->mixed = 1;
+        task->ret = ret;
+        return;
+      }
+
+      renderer->offset = decoder->delay > 0 ? decoder->delay : 0;
+      if (stream->trimming_start) renderer->offset = 0;
+      iamf_stream_render(renderer, f->data, out, ret);
+
+#if SR
+      // rendering
+      iamf_ren_stream_log(stream->element_id,
+                          stream->final_layout->channels, out, ret);
+#endif
+
+      f->data = out;
+
+      if (task->flush) {
+        f->etrim = decoder->frame_size - decoder->delay;
+        decoder->delay = 0;
+      }
+
+      if ((f->strim && f->strim < decoder->frame_size) ||
+          (f->etrim && f->etrim < decoder->frame_size) ||
+          stream->trimming_start) {
+        if (f->etrim > 0 && decoder->delay > 0) {
+          if (decoder->delay > f->etrim) {
+            decoder->delay -= f->etrim;
+            f->etrim = 0;
+          } else {
+            f->etrim -= decoder->delay;
+            decoder->delay = 0;
+          }
+        }
+        ret = iamf_frame_trim(f, f->strim, f->etrim,
+                              stream->trimming_start - f->strim);
+
+        ia_logd("The remaining samples %d after cutting.", ret);
+      }
+    }
+  }
+
+  if (ret > 0) f->gain = iamf_decoder_stream_gain(handle, s);
+  task->ret = ret;
+}
+
+/* decodes all streams of the presentation and mixes them into one frame. */
+static int iamf_decoder_mix_frame(IAMF_DecoderHandle handle, int flush,
+                                  float *mix) {
   IAMF_DecoderContext *ctx = &handle->ctx;
   IAMF_DataBase *db = &ctx->db;
   IAMF_Presentation *pst = ctx->presentation;
   IAMF_StreamDecoder *decoder;
-  IAMF_StreamRenderer *renderer;
   IAMF_Stream *stream;
   IAMF_Mixer *mixer = &pst->mixer;
-  SpeexResamplerState *resampler = pst->resampler;
   Frame *f;
   int ret = 0, lret = 1;
-  uint32_t r = 0;
   int real_frame_size = 0;
-  float *out = 0;
+  int mixed = 0;
   MixGainUnit *u = 0;
-  ElementItem *ei = 0;
+  ThreadPool *pool = handle->pool;
 
-  if (pst->nb_streams <= 0) return IAMF_ERR_INTERNAL;
+  if (!pst->tasks) return IAMF_ERR_INTERNAL;
 
-  if (data && size) {
-    r = iamf_decoder_internal_parse_OBUs(handle, data, size);
-    *rsize = r;
+#if SR
+  pool = 0;
+#endif
+#if DISABLE_BINAURALIZER == 0
+  // the streams share one binaural renderer, which is not reentrant.
+  if (ctx->output_layout->layout.type == IAMF_LAYOUT_TYPE_BINAURAL) pool = 0;
+#endif
+#if DISABLE_LFE_HOA == 0
+  // the ambisonics streams share the lfe filter of the output layout.
+  if (iamf_layout_lfe_check(&ctx->output_layout->layout)) pool = 0;
+#endif
+  // the streams decoded at the same time are mixed by the mixer.
+  for (int s = 0; s < pst->nb_streams; ++s) {
+    pst->tasks[s].flush = flush;
+    pst->tasks[s].mix = !s || !pool ? mix : 0;
+  }
+  thread_pool_run(pool, iamf_decoder_stream_task, handle, pst->nb_streams);
+  // the packets of all streams have been consumed.
+  iamf_presentation_count_pending(pst);
 
-    if (ctx->status == IAMF_DECODER_STATUS_RECONFIGURE) {
-      return IAMF_ERR_INVALID_STATE;
-    } else if (ctx->status != IAMF_DECODER_STATUS_RUN) {
-      return 0;
+  for (int s = 0; s < pst->nb_streams; ++s) {
+    decoder = pst->decoders[s];
+    stream = decoder->stream;
+    f = &decoder->frame;
+    ret = pst->tasks[s].ret;
+
+    if (!s && f->strim > 0) {
+      ia_logd("external pts is %" PRId64, ctx->pts);
+      ctx->pts +=
+          time_transform(f->strim, stream->sampling_rate, ctx->pts_time_base);
+      ia_logd("external pts changes to %" PRId64, ctx->pts);
     }
+
+    if (ret <= 0) {
+      if (ret < 0) ia_loge("fail to decode audio packet. error no. %d", ret);
+      stream->timestamp += decoder->frame_size;
+      lret = ret;
+      continue;
+    }
+
+    // metadata
+    if (decoder->stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED &&
+        ctx->metadata.param) {
+      ChannelLayerContext *cctx = (ChannelLayerContext *)stream->priv;
+      if (cctx->dmx_mode >= 0) ctx->metadata.param->dmixp_mode = cctx->dmx_mode;
+    }
+
+    iamf_mixer_add_frame(mixer, f);
+
+    // timestamp
+    stream->timestamp += decoder->frame_size;
+
+    if (mixed == s && pst->tasks[s].mixed) ++mixed;
   }
 
-  if ((data && size) || pst->decoders[0]->delay > 0) {
-    for (int s = 0; s < pst->nb_streams; ++s) {
-      renderer = pst->renderers[s];
-      decoder = pst->decoders[s];
-      stream = decoder->stream;
-      f = &decoder->frame;
-      f->data = decoder->buffers[0];
-      out = decoder->buffers[1];
-
-      f->pts = stream->timestamp;
-      if (decoder->delay > 0) f->pts -= decoder->delay;
-
-      ret = iamf_stream_decoder_decode(decoder, f->data);
-      iamf_stream_decoder_decode_finish(decoder);
-
-      if (ret > 0) {
-        ia_logd("strim %" PRIu64 ", etrim %" PRIu64
-                ", frame size %u, delay size %d",
-                f->strim, f->etrim, decoder->frame_size, decoder->delay);
-        if (f->strim == decoder->frame_size ||
-            f->etrim == decoder->frame_size) {
-          ret = 0;
-          ia_logd("The whole frame which size is %d has been cut.", f->samples);
-        } else {
-          f->samples = ret;
+  if (lret <= 0) return lret;
 
-#if SR
-          // decoding
-          iamf_rec_stream_log(stream->element_id, f->channels, f->data, ret);
-#endif
+  f = &pst->frame;
+  f->data = mix;
+  real_frame_size = iamf_mixer_mix(mixer, f, mixed);
 
-          if (decoder->frame_padding > 0) {
-            ia_logw("decoded result is %d, different frame size %d",
-                    ret - decoder->frame_padding, decoder->frame_size);
-            f->etrim += decoder->frame_padding;
-          }
+  ia_logd("frame pts %" PRIu64 ", id %" PRIu64, f->pts, pst->output_gain_id);
+
+  u = iamf_database_parameter_get_mix_gain_unit(
+      db, pst->output_gain_id, f->pts, f->samples,
+      pst->streams[0]->sampling_rate, &pst->output_gain);
+  if (u) iamf_frame_gain(f, u);
+
+  iamf_database_parameters_time_elapse(db, real_frame_size,
+                                       pst->streams[0]->sampling_rate);
+
+  return real_frame_size;
+}
+
+/* resamples, normalizes and limits the mixed frame, then outputs it. */
+static int iamf_decoder_post_process(IAMF_DecoderHandle handle, float *in,
+                                     float *out, int frame_size) {
+  IAMF_DecoderContext *ctx = &handle->ctx;
+  IAMF_Presentation *pst = ctx->presentation;
+
+  if (pst->resampler) {
+    frame_size = iamf_resample(pst->resampler, in, out, frame_size);
+    swap((void **)&in, (void **)&out);
+  }
 
-          renderer->offset = decoder->delay > 0 ? decoder->delay : 0;
-          if (stream->trimming_start) renderer->offset = 0;
-          iamf_stream_render(renderer, f->data, out, ret);
+  if (ctx->normalization_loudness) {
+    iamf_loudness_process(in, frame_size, ctx->output_layout->channels,
+                          db2lin(ctx->normalization_loudness - ctx->loudness));
+  }
+
+  if (handle->limiter) {
+    frame_size = audio_effect_peak_limiter_process_block(handle->limiter, in,
+                                                         out, frame_size);
+    swap((void **)&in, (void **)&out);
+  }
+
+  iamf_decoder_output(handle, in, frame_size);
 
 #if SR
-          // rendering
-          iamf_ren_stream_log(stream->element_id,
-                              stream->final_layout->channels, out, ret);
+  // mixing
+  iamf_mix_stream_log(ctx->output_layout->channels, out, frame_size);
 #endif
 
-          swap((void **)&f->data, (void **)&out);
-          f->channels = ctx->output_layout->channels;
+  return frame_size;
+}
 
-          if (!data || size <= 0) {
-            f->etrim = decoder->frame_size - decoder->delay;
-            decoder->delay = 0;
-          }
+static int iamf_decoder_pipeline_prepare(IAMF_DecoderHandle handle) {
+  IAMF_Pipeline *pl = &handle->pipeline;
+  IAMF_DecoderContext *ctx = &handle->ctx;
+  uint32_t size = ctx->info.max_frame_size * ctx->output_layout->channels;
 
-          if ((f->strim && f->strim < decoder->frame_size) ||
-              (f->etrim && f->etrim < decoder->frame_size) ||
-              stream->trimming_start) {
-            if (f->etrim > 0 && decoder->delay > 0) {
-              if (decoder->delay > f->etrim) {
-                decoder->delay -= f->etrim;
-                f->etrim = 0;
-              } else {
-                f->etrim -= decoder->delay;
-                decoder->delay = 0;
-              }
-            }
-            ret = iamf_frame_trim(f, f->strim, f->etrim,
-                                  stream->trimming_start - f->strim);
+  if (pl->buffer_size >= size) return IAMF_OK;
 
-            ia_logd("The remaining samples %d after cutting.", ret);
-          }
-        }
-      }
+  for (int i = 0; i < PIPELINE_BUF_CNT; ++i) {
+    float *buffer = IAMF_REALLOC(float, pl->buffers[i], size);
+    if (!buffer) return IAMF_ERR_ALLOC_FAIL;
+    pl->buffers[i] = buffer;
+  }
+  pl->buffer_size = size;
 
-      if (!s && f->strim > 0) {
-        ia_logd("external pts is %" PRId64, ctx->pts);
-        ctx->pts +=
-            time_transform(f->strim, stream->sampling_rate, ctx->pts_time_base);
-        ia_logd("external pts changes to %" PRId64, ctx->pts);
-      }
+  return IAMF_OK;
+}
 
-      if (ret <= 0) {
-        if (ret < 0) ia_loge("fail to decode audio packet. error no. %d", ret);
-        stream->timestamp += decoder->frame_size;
-        lret = ret;
-        continue;
-      }
-      real_frame_size = ret;
-
-      ei = iamf_database_element_get_item(db, stream->element_id);
-      if (ei && ei->mixGain) {
-        u = iamf_database_parameter_get_mix_gain_unit(
-            db, ei->mixGain->id, f->pts, f->samples, stream->sampling_rate);
-        if (u) {
-          iamf_frame_gain(f, u);
-          mix_gain_unit_free(u);
-        }
-      }
+/* task 0 mixes the next frame if any, the other one outputs the pending. */
+static void iamf_decoder_pipeline_task(void *arg, int index) {
+  IAMF_DecoderHandle handle = (IAMF_DecoderHandle)arg;
+  IAMF_Pipeline *pl = &handle->pipeline;
+  int p = pl->pending;
 
-      // metadata
-      if (decoder->stream->scheme == AUDIO_ELEMENT_TYPE_CHANNEL_BASED &&
-          ctx->metadata.param) {
-        IAMF_Stream *stream = decoder->stream;
-        ChannelLayerContext *cctx = (ChannelLayerContext *)stream->priv;
-        if (cctx->dmx_mode >= 0)
-          ctx->metadata.param->dmixp_mode = cctx->dmx_mode;
-      }
+  if (!index && pl->decode) {
+    pl->mixed = iamf_decoder_mix_frame(handle, pl->flush,
+                                       pl->buffers[(p + 1) % PIPELINE_BUF_CNT]);
+  } else {
+    pl->processed = iamf_decoder_post_process(
+        handle, pl->buffers[p], pl->buffers[(p + 2) % PIPELINE_BUF_CNT],
+        pl->samples);
+  }
+}
 
-      iamf_mixer_add_frame(mixer, f);
+/**
+ * The mixing of frame N and the post processing of frame N-1 run at the same
+ * time, so the output is one frame later than the serial decoding. The
+ * pending frame is output with the last frame when flushing.
+ * */
+static int iamf_decoder_pipeline_decode(IAMF_DecoderHandle handle, int decode,
+                                        int flush) {
+  IAMF_Pipeline *pl = &handle->pipeline;
+  int count;
+  int ret;
 
-      // timestamp
-      stream->timestamp += decoder->frame_size;
+  if (iamf_decoder_pipeline_prepare(handle) != IAMF_OK)
+    return IAMF_ERR_ALLOC_FAIL;
 
-      pst->frame.data = out;
-      out = f->data;
-    }
+  pl->decode = decode;
+  pl->flush = flush;
+  pl->mixed = pl->processed = 0;
 
-    if (lret <= 0) {
-      ctx->status = IAMF_DECODER_STATUS_RECEIVE;
-      return lret;
-    }
+  count = !!decode + (pl->samples > 0);
+#if SR
+  thread_pool_run(0, iamf_decoder_pipeline_task, handle, count);
+#else
+  thread_pool_run(handle->pool, iamf_decoder_pipeline_task, handle, count);
+#endif
 
-    f = &pst->frame;
-    real_frame_size = iamf_mixer_mix(mixer, f);
+  ret = pl->processed;
+  if (pl->mixed > 0) {
+    pl->pending = (pl->pending + 1) % PIPELINE_BUF_CNT;
+    pl->samples = pl->mixed;
+    if (flush) {
+      ret += iamf_decoder_post_process(
+          handle, pl->buffers[pl->pending],
+          pl->buffers[(pl->pending + 2) % PIPELINE_BUF_CNT], pl->samples);
+      pl->samples = 0;
+    }
+  } else {
+    pl->samples = 0;
+    if (!ret) return pl->mixed;
+  }
 
-    ia_logd("frame pts %" PRIu64 ", id %" PRIu64, f->pts, pst->output_gain_id);
+  return ret;
+}
 
-    u = iamf_database_parameter_get_mix_gain_unit(
-        db, pst->output_gain_id, f->pts, f->samples,
-        pst->streams[0]->sampling_rate);
-    if (u) {
-      iamf_frame_gain(f, u);
-      mix_gain_unit_free(u);
-    }
+static int iamf_decoder_internal_decode(IAMF_DecoderHandle handle,
+                                        const uint8_t *data, int32_t size,
+                                        uint32_t *rsize) {
+  IAMF_DecoderContext *ctx = &handle->ctx;
+  IAMF_Presentation *pst = ctx->presentation;
+  IAMF_Pipeline *pl = &handle->pipeline;
+  uint32_t r = 0;
+  int real_frame_size = 0;
+  int decode;
 
-    iamf_database_parameters_time_elapse(db, real_frame_size,
-                                         pst->streams[0]->sampling_rate);
+  if (pst->nb_streams <= 0) return IAMF_ERR_INTERNAL;
 
-    if (resampler) {
-      real_frame_size =
-          iamf_resample(pst->resampler, f->data, out, real_frame_size);
-      swap((void **)&f->data, (void **)&out);
-    }
+  if (data && size) {
+    r = iamf_decoder_internal_parse_OBUs(handle, data, size);
+    *rsize = r;
 
-    if (ctx->normalization_loudness) {
-      iamf_loudness_process(
-          f->data, real_frame_size, ctx->output_layout->channels,
-          db2lin(ctx->normalization_loudness - ctx->loudness));
+    if (ctx->status != IAMF_DECODER_STATUS_RUN) {
+      for (int s = 0; s < pst->nb_streams; ++s) {
+        if (iamf_packet_hold(&pst->decoders[s]->packet) != IAMF_OK)
+          return IAMF_ERR_ALLOC_FAIL;
+      }
     }
 
-    if (handle->limiter) {
-      real_frame_size = audio_effect_peak_limiter_process_block(
-          handle->limiter, f->data, out, real_frame_size);
-      swap((void **)&f->data, (void **)&out);
+    if (ctx->status == IAMF_DECODER_STATUS_RECONFIGURE) {
+      if (pl->enable && pl->samples > 0) {
+        real_frame_size = iamf_decoder_post_process(
+            handle, pl->buffers[pl->pending],
+            pl->buffers[(pl->pending + 2) % PIPELINE_BUF_CNT], pl->samples);
+        pl->samples = 0;
+        ctx->duration += real_frame_size;
+        ctx->last_frame_size = real_frame_size;
+        return real_frame_size;
+      }
+      return IAMF_ERR_INVALID_STATE;
+    } else if (ctx->status != IAMF_DECODER_STATUS_RUN) {
+      return 0;
     }
-
-#ifdef SAMSUNG_TV
-    iamf_decoder_plane2stride_out(pcm, f->data, real_frame_size,
-                                  ctx->output_layout->channels, ctx->bit_depth,
-                                  SAMSUNG_SPECIFIC_CHANNELS);
-#else
-    iamf_decoder_plane2stride_out(pcm, f->data, real_frame_size,
-                                  ctx->output_layout->channels, ctx->bit_depth,
-                                  ctx->output_layout->channels);
-#endif
-
-#if SR
-    // mixing
-    iamf_mix_stream_log(ctx->output_layout->channels, out, real_frame_size);
-#endif
   }
 
-  if (!data) {
-    if (real_frame_size > 0) {
-#ifdef SAMSUNG_TV
-      pcm = (char *)pcm +
-            ctx->bit_depth / 8 * real_frame_size * SAMSUNG_SPECIFIC_CHANNELS;
-#else
-      pcm = (char *)pcm +
-            ctx->bit_depth / 8 * real_frame_size * ctx->output_layout->channels;
-#endif
+  decode = (data && size) || pst->decoders[0]->delay > 0;
+  if (pl->enable) {
+    real_frame_size =
+        iamf_decoder_pipeline_decode(handle, decode, !data || size <= 0);
+    if (real_frame_size <= 0 && data) {
+      ctx->status = IAMF_DECODER_STATUS_RECEIVE;
+      return real_frame_size;
+    }
+    if (real_frame_size < 0) real_frame_size = 0;
+  } else if (decode) {
+    real_frame_size =
+        iamf_decoder_mix_frame(handle, !data || size <= 0, pst->buffers[0]);
+    if (real_frame_size <= 0) {
+      ctx->status = IAMF_DECODER_STATUS_RECEIVE;
+      return real_frame_size;
     }
-    real_frame_size += iamf_delay_buffer_handle(handle, pcm);
+    real_frame_size = iamf_decoder_post_process(handle, pst->buffers[0],
+                                                pst->buffers[1],
+                                                real_frame_size);
   }
 
+  if (!data) real_frame_size += iamf_delay_buffer_handle(handle);
+
   ctx->duration += real_frame_size;
   ctx->last_frame_size = real_frame_size;
   ctx->status = IAMF_DECODER_STATUS_RECEIVE;
@@ -3725,6 +4270,8 @@ void iamf_extra_data_reset(IAMF_extradata *data) {
 
 IAMF_DecoderHandle IAMF_decoder_open(void) {
   IAMF_DecoderHandle handle = 0;
+
+  sample_convert_init();
   handle = IAMF_MALLOCZ(struct IAMF_Decoder, 1);
   if (handle) {
     IAMF_DataBase *db = &handle->ctx.db;
@@ -3747,6 +4294,9 @@ int IAMF_decoder_close(IAMF_DecoderHandle handle) {
   if (handle) {
     iamf_decoder_internal_reset(handle);
     if (handle->limiter) audio_effect_peak_limiter_destroy(handle->limiter);
+    if (handle->pool) thread_pool_close(handle->pool);
+    for (int i = 0; i < PIPELINE_BUF_CNT; ++i)
+      IAMF_FREE(handle->pipeline.buffers[i]);
     free(handle);
   }
 #if SR
@@ -3769,6 +4319,7 @@ int iamf_decoder_internal_configure(IAMF_DecoderHandle handle,
 
   ctx = &handle->ctx;
   db = &ctx->db;
+  handle->pipeline.samples = 0;
   if (ctx->need_configure & IAMF_DECODER_CONFIG_OUTPUT_LAYOUT) {
     LayoutInfo *old = ctx->output_layout;
     ia_logd("old layout %p", old);
@@ -3867,6 +4418,7 @@ int iamf_decoder_internal_configure(IAMF_DecoderHandle handle,
           if (sr) iamf_stream_renderer_close(sr);
           pst->renderers[i] =
               iamf_stream_renderer_open(s, pst->obj, dec->frame_size);
+          iamf_stream_scale_demixer_set_demand(dec, pst->renderers[i]);
         }
         s = pst->streams[0];
         if (ctx->presentation->resampler) {
@@ -3940,7 +4492,28 @@ int IAMF_decoder_decode(IAMF_DecoderHandle handle, const uint8_t *data,
   if (!handle) return IAMF_ERR_BAD_ARG;
   if (handle->ctx.status != IAMF_DECODER_STATUS_RECEIVE)
     return IAMF_ERR_INVALID_STATE;
-  ret = iamf_decoder_internal_decode(handle, data, size, &rs, pcm);
+  handle->output.pcm = pcm;
+  handle->output.channels = 0;
+  handle->output.offset = 0;
+  ret = iamf_decoder_internal_decode(handle, data, size, &rs);
+  if (rsize) *rsize = rs;
+  return ret;
+}
+
+int IAMF_decoder_decode_float(IAMF_DecoderHandle handle, const uint8_t *data,
+                              int32_t size, uint32_t *rsize, float **pcm,
+                              uint32_t interleaved) {
+  uint32_t rs = 0;
+  int ret = IAMF_OK;
+
+  if (!handle || !pcm) return IAMF_ERR_BAD_ARG;
+  if (handle->ctx.status != IAMF_DECODER_STATUS_RECEIVE)
+    return IAMF_ERR_INVALID_STATE;
+  handle->output.pcm = 0;
+  handle->output.channels = pcm;
+  handle->output.interleaved = !!interleaved;
+  handle->output.offset = 0;
+  ret = iamf_decoder_internal_decode(handle, data, size, &rs);
   if (rsize) *rsize = rs;
   return ret;
 }
@@ -4129,6 +4702,43 @@ int IAMF_decoder_set_sampling_rate(IAMF_DecoderHandle handle, uint32_t rate) {
   return ret;
 }
 
+int IAMF_decoder_set_threads(IAMF_DecoderHandle handle, uint32_t threads) {
+  if (!handle) return IAMF_ERR_BAD_ARG;
+  if (threads == thread_pool_get_threads(handle->pool)) return IAMF_OK;
+  if (handle->pipeline.enable && threads < 2) {
+    ia_logw("Pipelined decoding needs at least 2 threads.");
+    return IAMF_ERR_INVALID_STATE;
+  }
+
+  if (handle->pool) {
+    thread_pool_close(handle->pool);
+    handle->pool = 0;
+  }
+
+  if (threads > 1) {
+    handle->pool = thread_pool_open(threads);
+    if (!handle->pool) return IAMF_ERR_ALLOC_FAIL;
+  }
+
+  return IAMF_OK;
+}
+
+int IAMF_decoder_pipeline_enable(IAMF_DecoderHandle handle, uint32_t enable) {
+  if (!handle) return IAMF_ERR_BAD_ARG;
+  if (handle->ctx.status != IAMF_DECODER_STATUS_INIT) {
+    ia_logw("Please enable pipeline before configuration.");
+    return IAMF_ERR_INVALID_STATE;
+  }
+
+  if (!!enable && !handle->pool) {
+    handle->pool = thread_pool_open(2);
+    if (!handle->pool) return IAMF_ERR_ALLOC_FAIL;
+  }
+  handle->pipeline.enable = !!enable;
+
+  return IAMF_OK;
+}
+
 IAMF_StreamInfo *IAMF_decoder_get_stream_info(IAMF_DecoderHandle handle) {
   return &handle->ctx.info;
 }
@@ -45,8 +45,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "audio_effect_peak_limiter.h"
 #include "demixer.h"
 #include "downmix_renderer.h"
-#include "queue_t.h"
 #include "speex_resampler.h"
+#include "thread_pool.h"
 
 #define IAMF_FLAG_MAGIC_CODE 0x01
 #define IAMF_FLAG_CODEC_CONFIG 0x02
@@ -58,6 +58,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
    IAMF_FLAG_MIX_PRESENTATION)
 
 #define DEC_BUF_CNT 3
+#define PIPELINE_BUF_CNT 3
+// the segments of a parameter which are allocated in configuration.
+#define PARAMETER_SEGMENTS_RESERVED 8
+// the initial capacity of a held sub packet, 32-bit stereo pcm.
+#define SUB_PACKET_BYTES_PER_SAMPLE 8
 
 typedef enum {
   IA_CH_GAIN_RTF,
@@ -89,10 +94,26 @@ typedef struct ObjectSet {
   IAMF_Free objFree;
 } ObjectSet;
 
+/* the samples of a run use a constant gain, or the gains of a curve. */
+typedef struct MixGainRun {
+  int count;
+  float gain;
+  float *gains;
+} MixGainRun;
+
+/**
+ * The gains of a frame. The constant gain is used for all samples when there
+ * is no run, otherwise the runs cover the samples in order.
+ * */
 typedef struct MixGainUnit {
   int count;
   float constant_gain;
-  float *gains;
+  MixGainRun *runs;
+  int nb_runs;
+
+  // the storage of runs and curves, which is allocated with the presentation.
+  float *buffer;
+  int size;
 } MixGainUnit;
 
 typedef struct MixGain {
@@ -100,8 +121,21 @@ typedef struct MixGain {
   int use_default;
 } MixGain;
 
+/**
+ * The received segments of a parameter in decoding order. The end of each
+ * segment is accumulated from an origin, and the first one starts at start.
+ * */
+typedef struct ParameterSegments {
+  ParameterSegment **items;
+  uint64_t *ends;
+  uint64_t start;
+  int head;
+  int count;
+  int size;
+} ParameterSegments;
+
 typedef struct ParameterValue {
-  queue_t *params;
+  ParameterSegments segments;
   union {
     MixGain mix_gain;
   };
@@ -119,6 +153,7 @@ typedef struct ParameterItem {
   ParameterBase *param_base;
 
   ParameterValue value;
+  ParameterSegmentPool pool;
 } ParameterItem;
 
 typedef struct ElementItem {
@@ -135,10 +170,19 @@ typedef struct ElementItem {
 
 typedef void (*free_tp)(void *);
 
+typedef struct ViewerEntry {
+  uint64_t id;
+  void *item;
+} ViewerEntry;
+
 typedef struct Viewer {
   void **items;
   int count;
   free_tp freeF;
+
+  // the open addressing index of the items by id, its size is a power of 2.
+  ViewerEntry *index;
+  int index_size;
 } Viewer;
 
 typedef struct IAMF_DataBase {
@@ -150,6 +194,8 @@ typedef struct IAMF_DataBase {
 
   Viewer eViewer;
   Viewer pViewer;
+
+  IAMF_Parameter param;  // the parameter block being received.
 } IAMF_DataBase;
 
 /* <<<<<<<<<<<<<<<<<< DATABASE <<<<<<<<<<<<<<<<<< */
@@ -244,6 +290,11 @@ typedef struct Packet {
   uint32_t *sub_packet_sizes;
   uint32_t nb_sub_packets;
   uint32_t count;
+
+  // the sub packets refer to the input data, or are held in the buffer, the
+  // capacity of each one is buffer_size.
+  uint8_t *buffer;
+  uint32_t buffer_size;
 } Packet;
 
 typedef struct Frame {
@@ -255,6 +306,8 @@ typedef struct Frame {
   int channels;
 
   float *data;
+  // the element mix gain which is applied when mixing, or null.
+  MixGainUnit *gain;
 } Frame;
 
 typedef struct IAMF_StreamDecoder {
@@ -273,6 +326,7 @@ typedef struct IAMF_StreamDecoder {
   int frame_padding;
   int delay;
 
+  ThreadPool *pool;
 } IAMF_StreamDecoder;
 
 typedef struct IAMF_StreamRenderer {
@@ -281,12 +335,15 @@ typedef struct IAMF_StreamRenderer {
   uint32_t offset;
   uint32_t frame_size;
   uint8_t headphones_rendering_mode;
+  float **sin;
+  float **sout;
   struct {
     IAMF_SP_LAYOUT *layout;
     union {
       struct m2m_rdr_t mr;
       struct h2m_rdr_t hr;
     };
+    struct rdr_sparse_t *sparse;  // the taps of the matrix.
   } renderer;
 } IAMF_StreamRenderer;
 
@@ -296,6 +353,21 @@ typedef struct IAMF_Mixer {
   Frame **frames;
 } IAMF_Mixer;
 
+typedef struct IAMF_StreamTask {
+  float *mix;  // the mixed frame which the stream can be rendered into.
+  int mixed;   // the stream has been rendered into the mixed frame.
+  int flush;
+  int ret;
+  MixGainUnit gain;
+} IAMF_StreamTask;
+
+/* the stream and the index in the stream of an audio substream. */
+typedef struct SubstreamRoute {
+  uint64_t id;
+  int stream;
+  int index;
+} SubstreamRoute;
+
 typedef struct IAMF_Presentation {
   IAMF_MixPresentation *obj;
 
@@ -307,6 +379,21 @@ typedef struct IAMF_Presentation {
   IAMF_Mixer mixer;
   uint64_t output_gain_id;
   Frame frame;
+  IAMF_StreamTask *tasks;
+  MixGainUnit output_gain;
+  // the number of substreams whose packets are not received for the frame.
+  int nb_pending;
+
+  // the open addressing table of substream ids, its size is a power of 2.
+  SubstreamRoute *routes;
+  int routes_size;
+
+  // the mixed frame and the output of the post processing, which are used to
+  // flush the delay signal of the resampler and the limiter too.
+  float *buffers[2];
+
+  // the memory which is used by decoding and allocated in configuration.
+  uint8_t *arena;
 } IAMF_Presentation;
 
 typedef struct IAMF_DecoderContext {
@@ -339,9 +426,36 @@ typedef struct IAMF_DecoderContext {
 
 } IAMF_DecoderContext;
 
+typedef struct IAMF_Pipeline {
+  uint32_t enable;
+  float *buffers[PIPELINE_BUF_CNT];
+  uint32_t buffer_size;
+
+  // the mixed frame which waits for post processing.
+  int pending;
+  int samples;
+
+  int decode;
+  int flush;
+  int mixed;
+  int processed;
+} IAMF_Pipeline;
+
+typedef struct IAMF_Output {
+  void *pcm;
+  // the float output, the pcm is used if it is null.
+  float **channels;
+  int interleaved;
+  // the number of samples which have been output in the decoding call.
+  int offset;
+} IAMF_Output;
+
 struct IAMF_Decoder {
   IAMF_DecoderContext ctx;
   AudioEffectPeakLimiter *limiter;
+  ThreadPool *pool;
+  IAMF_Pipeline pipeline;
+  IAMF_Output output;
 };
 
 #endif /* IAMF_DECODER_PRIVATE_H */
@@ -45,11 +45,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IA_TAG "IAMF_AAC"
 
-static int iamf_aac_close(IAMF_CodecContext *ths);
-
 typedef struct IAMF_AAC_Context {
   AACMSDecoder *dec;
-  short *out;
 } IAMF_AAC_Context;
 
 /**
@@ -103,13 +100,6 @@ static int iamf_aac_init(IAMF_CodecContext *ths) {
     return IAMF_ERR_INVALID_STATE;
   }
 
-  ctx->out = (short *)malloc(sizeof(short) * MAX_AAC_FRAME_SIZE *
-                             (ths->streams + ths->coupled_streams));
-  if (!ctx->out) {
-    iamf_aac_close(ths);
-    return IAMF_ERR_ALLOC_FAIL;
-  }
-
   return IAMF_OK;
 }
 
@@ -118,22 +108,12 @@ static int iamf_aac_decode(IAMF_CodecContext *ths, uint8_t *buffer[],
                            uint32_t frame_size) {
   IAMF_AAC_Context *ctx = (IAMF_AAC_Context *)ths->priv;
   AACMSDecoder *dec = (AACMSDecoder *)ctx->dec;
-  int ret = IAMF_OK;
 
   if (count != ths->streams) {
     return IAMF_ERR_BAD_ARG;
   }
 
-  ret = aac_multistream_decode(dec, buffer, size, ctx->out, frame_size);
-  if (ret > 0) {
-    float *out = (float *)pcm;
-    uint32_t samples = ret * (ths->streams + ths->coupled_streams);
-    for (int i = 0; i < samples; ++i) {
-      out[i] = ctx->out[i] / 32768.f;
-    }
-  }
-
-  return ret;
+  return aac_multistream_decode(dec, buffer, size, pcm, frame_size, ths->pool);
 }
 
 int iamf_aac_info(IAMF_CodecContext *ths) {
@@ -143,7 +123,7 @@ int iamf_aac_info(IAMF_CodecContext *ths) {
   return IAMF_OK;
 }
 
-int iamf_aac_close(IAMF_CodecContext *ths) {
+static int iamf_aac_close(IAMF_CodecContext *ths) {
   IAMF_AAC_Context *ctx = (IAMF_AAC_Context *)ths->priv;
   AACMSDecoder *dec = (AACMSDecoder *)ctx->dec;
 
@@ -151,9 +131,6 @@ int iamf_aac_close(IAMF_CodecContext *ths) {
     aac_multistream_decoder_close(dec);
     ctx->dec = 0;
   }
-  if (ctx->out) {
-    free(ctx->out);
-  }
 
   return IAMF_OK;
 }
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IAMF_types.h"
 #include "IAMF_utils.h"
 #include "fdk-aac/aacdecoder_lib.h"
+#include "sample_convert.h"
 
 #ifdef IA_TAG
 #undef IA_TAG
@@ -58,25 +59,20 @@ struct AACMSDecoder {
   int delay;
 
   HANDLE_AACDECODER *handles;
-  INT_PCM buffer[MAX_BUFFER_SIZE];
+  INT_PCM *buffers;
+  int *results;
+
+  uint8_t **packets;
+  uint32_t *sizes;
 };
 
 typedef void (*aac_copy_channel_out_func)(void *dst, const void *src,
                                           int frame_size, int channes);
 
-void aac_copy_channel_out_short_plane(void *dst, const void *src,
+static void aac_copy_channel_out_float_plane(void *dst, const void *src,
                                       int frame_size, int channels) {
-  if (channels == 1) {
-    memcpy(dst, src, sizeof(INT_PCM) * frame_size);
-  } else if (channels == 2) {
-    INT_PCM *in, *out;
-    in = (INT_PCM *)src;
-    out = (INT_PCM *)dst;
-    for (int s = 0; s < frame_size; ++s) {
-      out[s] = in[channels * s];
-      out[s + frame_size] = in[channels * s + 1];
-    }
-  }
+  sample_convert_stride2plane_s16((float *)dst, (const int16_t *)src,
+                                  frame_size, channels);
 }
 
 static int aac_config_set_channels(uint8_t *conf, uint32_t size, int channels) {
@@ -100,34 +96,49 @@ static int aac_config_set_channels(uint8_t *conf, uint32_t size, int channels) {
   return IAMF_OK;
 }
 
+static void aac_multistream_decode_task(void *arg, int i) {
+  AACMSDecoder *st = (AACMSDecoder *)arg;
+  UINT valid = st->sizes[i];
+  UINT flags = st->packets[i] ? 0 : AACDEC_FLUSH;
+  AAC_DECODER_ERROR err;
+
+  ia_logt("stream %d", i);
+  if (!flags) {
+    err = aacDecoder_Fill(st->handles[i], &st->packets[i], &st->sizes[i],
+                          &valid);
+    if (err != AAC_DEC_OK) {
+      st->results[i] = IAMF_ERR_INVALID_PACKET;
+      return;
+    }
+  }
+  err = aacDecoder_DecodeFrame(st->handles[i],
+                               st->buffers + i * MAX_BUFFER_SIZE,
+                               MAX_BUFFER_SIZE, flags);
+  if (err == AAC_DEC_NOT_ENOUGH_BITS) {
+    st->results[i] = IAMF_ERR_BUFFER_TOO_SMALL;
+  } else if (err != AAC_DEC_OK) {
+    ia_loge("stream %d : fail to decode", i);
+    st->results[i] = IAMF_ERR_INTERNAL;
+  } else {
+    st->results[i] = IAMF_OK;
+  }
+}
+
 static int aac_multistream_decode_native(
     AACMSDecoder *st, uint8_t *buffer[], uint32_t size[], void *pcm,
-    int frame_size, aac_copy_channel_out_func copy_channel_out) {
-  UINT valid;
-  AAC_DECODER_ERROR err;
-  INT_PCM *out = (INT_PCM *)pcm;
+    int frame_size, ThreadPool *pool,
+    aac_copy_channel_out_func copy_channel_out) {
+  float *out = (float *)pcm;
   int fs = 0;
-  UINT flags = 0;
   CStreamInfo *info = 0;
 
+  st->packets = buffer;
+  st->sizes = size;
+  thread_pool_run(pool, aac_multistream_decode_task, st, st->streams);
+
   for (int i = 0; i < st->streams; ++i) {
-    ia_logt("stream %d", i);
-    valid = size[i];
-    flags = buffer[i] ? 0 : AACDEC_FLUSH;
-    if (!flags) {
-      err = aacDecoder_Fill(st->handles[i], &buffer[i], &size[i], &valid);
-      if (err != AAC_DEC_OK) {
-        return IAMF_ERR_INVALID_PACKET;
-      }
-    }
-    err = aacDecoder_DecodeFrame(st->handles[i], st->buffer, MAX_BUFFER_SIZE,
-                                 flags);
-    if (err == AAC_DEC_NOT_ENOUGH_BITS) {
-      return IAMF_ERR_BUFFER_TOO_SMALL;
-    }
-    if (err != AAC_DEC_OK) {
-      ia_loge("stream %d : fail to decode", i);
-      return IAMF_ERR_INTERNAL;
+    if (st->results[i] < 0) {
+      return st->results[i];
     }
 
     info = aacDecoder_GetStreamInfo(st->handles[i]);
@@ -149,7 +160,8 @@ static int aac_multistream_decode_native(
     }
 
     if (info) {
-      (*copy_channel_out)(out, st->buffer, fs, info->numChannels);
+      (*copy_channel_out)(out, st->buffers + i * MAX_BUFFER_SIZE, fs,
+                          info->numChannels);
       out += (fs * info->numChannels);
     } else {
       ia_logw("Can not get stream info.");
@@ -195,6 +207,14 @@ AACMSDecoder *aac_multistream_decoder_open(uint8_t *config, uint32_t size,
     goto end;
   }
 
+  st->buffers = IAMF_MALLOC(INT_PCM, MAX_BUFFER_SIZE * streams);
+  st->results = IAMF_MALLOCZ(int, streams);
+  if (!st->buffers || !st->results) {
+    ret = IAMF_ERR_ALLOC_FAIL;
+    IAMF_FREE(handles);
+    goto end;
+  }
+
   st->flags = flags;
   st->streams = streams;
   st->coupled_streams = coupled_streams;
@@ -242,10 +262,11 @@ end:
 }
 
 int aac_multistream_decode(AACMSDecoder *st, uint8_t *buffer[], uint32_t size[],
-                           void *pcm, uint32_t frame_size) {
+                           void *pcm, uint32_t frame_size, ThreadPool *pool) {
   if (st->flags & AUDIO_FRAME_PLANE)
     return aac_multistream_decode_native(st, buffer, size, pcm, frame_size,
-                                         aac_copy_channel_out_short_plane);
+                                         pool,
+                                         aac_copy_channel_out_float_plane);
   ia_loge("flags is 0x%x, is not implmeneted.", st->flags);
   return IAMF_ERR_UNIMPLEMENTED;
 }
@@ -260,6 +281,8 @@ void aac_multistream_decoder_close(AACMSDecoder *st) {
       }
       free(st->handles);
     }
+    IAMF_FREE(st->buffers);
+    IAMF_FREE(st->results);
     free(st);
   }
 }
@@ -37,6 +37,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 
+#include "thread_pool.h"
+
 typedef struct AACMSDecoder AACMSDecoder;
 
 AACMSDecoder *aac_multistream_decoder_open(uint8_t *config, uint32_t size,
@@ -44,7 +46,7 @@ AACMSDecoder *aac_multistream_decoder_open(uint8_t *config, uint32_t size,
                                            uint32_t flags, int *error);
 
 int aac_multistream_decode(AACMSDecoder *st, uint8_t *buffer[], uint32_t len[],
-                           void *pcm, uint32_t frame_size);
+                           void *pcm, uint32_t frame_size, ThreadPool *pool);
 
 void aac_multistream_decoder_close(AACMSDecoder *st);
 
@@ -131,6 +131,17 @@ typedef struct {
   int lfe_on;  // HOA lfe on/off
 } IAMF_HOA_LAYOUT;
 
+struct rdr_tap_t {
+  int input;
+  float gain;
+};
+
+// the taps of output n are from taps[offsets[n]] to taps[offsets[n + 1] - 1].
+struct rdr_sparse_t {
+  int *offsets;
+  struct rdr_tap_t *taps;
+};
+
 struct m2m_rdr_t {
   IAMF_SOUND_SYSTEM in;
   IAMF_SOUND_SYSTEM out;
@@ -150,6 +161,25 @@ struct h2m_rdr_t {
   int n;
 };
 
+// Matrix mixing, the coefficient of input m and output n is
+// mat[m * mstride + n * nstride].
+void IAMF_element_renderer_render_matrix(const float *mat, int mstride,
+                                         int nstride, float *in[], int m_size,
+                                         float *out[], int n_size,
+                                         int nsamples);
+struct rdr_sparse_t *IAMF_element_renderer_sparse_open(const float *mat,
+                                                       int mstride,
+                                                       int nstride, int m_size,
+                                                       int n_size);
+void IAMF_element_renderer_sparse_close(struct rdr_sparse_t *sparse);
+// Renders the output n only.
+void IAMF_element_renderer_render_sparse_channel(struct rdr_sparse_t *sparse,
+                                                 float *in[], int n, float *o,
+                                                 int nsamples);
+void IAMF_element_renderer_render_sparse(struct rdr_sparse_t *sparse,
+                                         float *in[], float *out[], int n_size,
+                                         int nsamples);
+
 // Multichannel to Multichannel
 int IAMF_element_renderer_get_M2M_matrix(IAMF_SP_LAYOUT *in,
                                          IAMF_SP_LAYOUT *out,
@@ -157,7 +187,8 @@ int IAMF_element_renderer_get_M2M_matrix(IAMF_SP_LAYOUT *in,
 int IAMF_element_renderer_get_M2M_custom_matrix(IAMF_SP_LAYOUT *in,
                                                 IAMF_CUSTOM_SP_LAYOUT *out,
                                                 struct m2m_rdr_t *outMatrix);
-int IAMF_element_renderer_render_M2M(struct m2m_rdr_t *m2mMatrix, float *in[],
+int IAMF_element_renderer_render_M2M(struct m2m_rdr_t *m2mMatrix,
+                                     struct rdr_sparse_t *sparse, float *in[],
                                      float *out[], int nsamples);
 
 // HOA to Multichannel
@@ -173,9 +204,16 @@ int IAMF_element_renderer_get_H2M_matrix(IAMF_HOA_LAYOUT *in,
 int IAMF_element_renderer_get_H2M_custom_matrix(
     IAMF_HOA_LAYOUT *in_layout, IAMF_CUSTOM_SP_LAYOUT *out_layout,
     struct h2m_rdr_t *outMatrix);
-int IAMF_element_renderer_render_H2M(struct h2m_rdr_t *h2mMatrix, float *in[],
+int IAMF_element_renderer_render_H2M(struct h2m_rdr_t *h2mMatrix,
+                                     struct rdr_sparse_t *sparse, float *in[],
                                      float *out[], int nsamples,
                                      lfe_filter_t *lfe);
+// The output channel of the row n of the matrix, the lfe channels are skipped.
+int IAMF_element_renderer_get_H2M_channel(struct h2m_rdr_t *h2mMatrix, int n);
+// Generates the signal of the lfe channels, the filter runs once per call.
+void IAMF_element_renderer_render_H2M_lfe(struct h2m_rdr_t *h2mMatrix,
+                                          float *in[], float *out,
+                                          int nsamples, lfe_filter_t *lfe);
 
 #if DISABLE_BINAURALIZER == 0
 // ys_son**
@@ -34,148 +34,77 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "bitstream.h"
 
-#include <assert.h>
 #include <string.h>
 
 int32_t bs(BitStream *b, const uint8_t *data, int size) {
   b->data = data;
   b->size = size;
-  b->b8sp = b->b8p = 0;
+  b->next = 0;
+  b->cache = 0;
+  b->bits = 0;
 
   return 0;
 }
 
-static uint32_t bs_getLastA32b(BitStream *b) {
-  uint32_t ret = 0;
-  int n = 4;
-
-  if (b->b8sp >= b->size) return 0;
-  if (b->b8sp + 4 > b->size) n = b->size - b->b8sp;
-
-  for (int i = 0; i < n; ++i) {
-    ret <<= INT8_BITS;
-    ret |= b->data[b->b8sp + i];
-  }
-
-  n = 4 - n;
-  if (n > 0) ret <<= (INT8_BITS * n);
-
-  return ret;
+static uint64_t bs_load_be64(const uint8_t *p) {
+  return (uint64_t)p[0] << 56 | (uint64_t)p[1] << 48 | (uint64_t)p[2] << 40 |
+         (uint64_t)p[3] << 32 | (uint64_t)p[4] << 24 | (uint64_t)p[5] << 16 |
+         (uint64_t)p[6] << 8 | (uint64_t)p[7];
 }
 
-uint32_t bs_get32b(BitStream *b, int n) {
-  uint32_t ret = 0;
-  uint32_t nb8p = 0, nn;
-
-  assert(n <= INT32_BITS);
-
-  ret = bs_getLastA32b(b);
-  if (n + b->b8p > INT32_BITS) {
-    nb8p = n + b->b8p - INT32_BITS;
-    nn = INT32_BITS - b->b8p;
+/**
+ * Fills the cache to 56 bits at least. The bits below the cached ones are
+ * zero or the following bits of data, so they can be merged by or.
+ * */
+void bs_refill(BitStream *b) {
+  if (b->next + 8 <= b->size) {
+    b->cache |= bs_load_be64(b->data + b->next) >> b->bits;
+    b->next += (63 - b->bits) >> 3;
+    b->bits |= 56;
   } else {
-    nn = n;
-  }
-
-  ret >>= INT32_BITS - nn - b->b8p;
-  if (nn < INT32_BITS) {
-    ret &= ~((~0U) << nn);
-  }
-  b->b8p += nn;
-  b->b8sp += (b->b8p / INT8_BITS);
-  b->b8p %= INT8_BITS;
-
-  if (nb8p) {
-    uint32_t nret = bs_get32b(b, nb8p);
-    ret <<= nb8p;
-    ret |= nret;
+    while (b->bits <= 56) {
+      if (b->next < b->size)
+        b->cache |= (uint64_t)b->data[b->next] << (56 - b->bits);
+      ++b->next;
+      b->bits += INT8_BITS;
+    }
   }
-
-  return ret;
-}
-
-int32_t bs_skip(BitStream *b, int n) {
-  b->b8p += n;
-  b->b8sp += (b->b8p / INT8_BITS);
-  b->b8p %= INT8_BITS;
-
-  return 0;
 }
 
-void bs_align(BitStream *b) {
-  if (b->b8p) {
-    ++b->b8sp;
-    b->b8p = 0;
-  }
+void bs_seek(BitStream *b, uint64_t pos) {
+  b->next = (uint32_t)(pos / INT8_BITS);
+  b->cache = 0;
+  b->bits = 0;
+  bs_get32b(b, pos % INT8_BITS);
 }
 
 int32_t bs_skipABytes(BitStream *b, int n) { return bs_read(b, 0, n); }
 
-uint32_t bs_getA8b(BitStream *b) {
-  uint32_t ret;
-
-  bs_align(b);
-  ret = b->data[b->b8sp];
-  ++b->b8sp;
-  return ret;
-}
-
-uint32_t bs_getA16b(BitStream *b) {
-  uint32_t ret = bs_getA8b(b);
-  ret <<= INT8_BITS;
-  ret |= bs_getA8b(b);
-  return ret;
-}
-
-uint32_t bs_getA32b(BitStream *b) {
-  uint32_t ret = bs_getA16b(b);
-  ret <<= INT16_BITS;
-  ret |= bs_getA16b(b);
-  return ret;
-}
-
-uint64_t bs_getAleb128(BitStream *b) {
-  uint64_t ret = 0;
-  uint32_t i;
-  uint8_t byte;
-
-  bs_align(b);
-
-  if (b->b8sp >= b->size) return 0;
-
-  for (i = 0; i < 8; i++) {
-    if (b->b8sp + i >= b->size) break;
-    byte = b->data[b->b8sp + i];
-    ret |= (((uint64_t)byte & 0x7f) << (i * 7));
-    if (!(byte & 0x80)) {
-      break;
-    }
-  }
-  ++i;
-  b->b8sp += i;
-  return ret;
-}
-
 int32_t bs_read(BitStream *b, uint8_t *data, int n) {
-  bs_align(b);
-  if (data) memcpy(data, &b->data[b->b8sp], n);
-  b->b8sp += n;
+  uint32_t p = bs_uncache(b);
+
+  if (data) memcpy(data, &b->data[p], n);
+  b->next = p + n;
   return n;
 }
 
 int32_t bs_readString(BitStream *b, char *data, int n) {
   int len = 0, rlen = 0;
-  bs_align(b);
-  len = strlen((char *)&b->data[b->b8sp]) + 1;
+  uint32_t p;
+
+  p = bs_uncache(b);
+  len = strlen((char *)&b->data[p]) + 1;
   rlen = len;
   if (rlen > n) rlen = n;
-  memcpy(data, &b->data[b->b8sp], rlen - 1);
+  memcpy(data, &b->data[p], rlen - 1);
   data[rlen - 1] = '\0';
-  b->b8sp += len;
+  b->next = p + len;
   return len;
 }
 
-uint32_t bs_tell(BitStream *b) { return b->b8p ? b->b8sp + 1 : b->b8sp; }
+uint32_t bs_tell(BitStream *b) {
+  return (uint32_t)((bs_pos(b) + INT8_BITS - 1) / INT8_BITS);
+}
 
 uint8_t readu8(uint8_t *data, int offset) { return data[offset]; }
 
@@ -202,7 +131,7 @@ uint32_t readu24be(uint8_t *data, int offset) {
 }
 
 int reads24be(uint8_t *data, int offset) {
-  uint32_t ret = readu16le(data, offset) << 8 | data[offset + 2];
+  uint32_t ret = readu16be(data, offset) << 8 | data[offset + 2];
   int iret = ret << 8;
   return (iret >> 8);
 }
@@ -41,26 +41,116 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INT16_BITS 16
 #define INT32_BITS 32
 
+/**
+ * The bits are read through a cache of 64 bits, the first unread bit is the
+ * msb of the cache. The bits after the end of data are read as zero.
+ * */
 typedef struct {
   const uint8_t *data;
   uint32_t size;
-  uint32_t b8sp;  // bytes, less than size;
-  uint32_t b8p;   // 0~7
+  uint32_t next;  // the next byte to be cached.
+  uint64_t cache;
+  uint32_t bits;  // the number of cached bits, 0~64.
 } BitStream;
 
 int32_t bs(BitStream *b, const uint8_t *data, int size);
-uint32_t bs_get32b(BitStream *b, int n);
-int32_t bs_skip(BitStream *b, int n);
-void bs_align(BitStream *b);
+void bs_refill(BitStream *b);
+void bs_seek(BitStream *b, uint64_t pos);
 int32_t bs_skipABytes(BitStream *b, int n);
-uint32_t bs_getA8b(BitStream *b);
-uint32_t bs_getA16b(BitStream *b);
-uint32_t bs_getA32b(BitStream *b);
-uint64_t bs_getAleb128(BitStream *b);
 int32_t bs_read(BitStream *b, uint8_t *data, int n);
 int32_t bs_readString(BitStream *b, char *data, int n);
 uint32_t bs_tell(BitStream *b);
 
+/* the position in bits. */
+static inline uint64_t bs_pos(BitStream *b) {
+  return (uint64_t)b->next * INT8_BITS - b->bits;
+}
+
+/* peeks n (1~32) bits. */
+static inline uint32_t bs_peek(BitStream *b, int n) {
+  if (b->bits < (uint32_t)n) bs_refill(b);
+  return (uint32_t)(b->cache >> (64 - n));
+}
+
+static inline uint32_t bs_get32b(BitStream *b, int n) {
+  uint32_t ret;
+
+  if (n <= 0) return 0;
+  ret = bs_peek(b, n);
+  b->cache <<= n;
+  b->bits -= n;
+  return ret;
+}
+
+static inline int32_t bs_skip(BitStream *b, int n) {
+  if ((uint32_t)n < b->bits) {
+    b->cache <<= n;
+    b->bits -= n;
+  } else {
+    bs_seek(b, bs_pos(b) + n);
+  }
+  return 0;
+}
+
+static inline void bs_align(BitStream *b) {
+  uint32_t n = b->bits & (INT8_BITS - 1);
+  b->cache <<= n;
+  b->bits -= n;
+}
+
+/**
+ * Aligns to the next byte and empties the cache, returns the byte position.
+ * The aligned reads use the bytes of data directly from there.
+ * */
+static inline uint32_t bs_uncache(BitStream *b) {
+  b->next -= b->bits / INT8_BITS;
+  b->cache = 0;
+  b->bits = 0;
+  return b->next;
+}
+
+/* reads n (1~4) bytes at the byte position p, which is returned by uncache. */
+static inline uint32_t bs_get_bytes(BitStream *b, uint32_t p, int n) {
+  uint32_t ret = 0;
+
+  b->next = p + n;
+  if (p + n <= b->size) {
+    for (int i = 0; i < n; ++i) ret = ret << INT8_BITS | b->data[p + i];
+  } else {
+    for (int i = 0; i < n; ++i)
+      ret = ret << INT8_BITS | (p + i < b->size ? b->data[p + i] : 0);
+  }
+  return ret;
+}
+
+static inline uint32_t bs_getA8b(BitStream *b) {
+  return bs_get_bytes(b, bs_uncache(b), 1);
+}
+
+static inline uint32_t bs_getA16b(BitStream *b) {
+  return bs_get_bytes(b, bs_uncache(b), 2);
+}
+
+static inline uint32_t bs_getA32b(BitStream *b) {
+  return bs_get_bytes(b, bs_uncache(b), 4);
+}
+
+/* reads a leb128 value of 8 bytes at most. */
+static inline uint64_t bs_getAleb128(BitStream *b) {
+  uint32_t p = bs_uncache(b);
+  uint64_t ret = 0;
+  uint32_t i;
+
+  if (p >= b->size) return 0;
+
+  for (i = 0; i < 8 && p + i < b->size; ++i) {
+    ret |= ((uint64_t)b->data[p + i] & 0x7f) << (i * 7);
+    if (!(b->data[p + i] & 0x80)) break;
+  }
+  b->next = p + i + 1;
+  return ret;
+}
+
 int reads16be(uint8_t *data, int offset);
 int reads16le(uint8_t *data, int offset);
 int reads24be(uint8_t *data, int offset);
@@ -51,6 +51,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IA_TAG "IAMF_DMX"
 
+// the number of samples demixed at a time.
+#define DMX_BLOCK_SIZE 128
+
 /**
  * alpha and beta are gain values used for S7to5 down-mixer,
  * gamma for T4to2 downmixer,
@@ -91,6 +94,10 @@ struct Demixer {
   IAChannel chs_out[IA_CH_LAYOUT_MAX_CHANNELS];
   int chs_count;
 
+  // the output channels which are read, the others are left silent.
+  uint32_t output_mask;
+  uint8_t chs_unused[IA_CH_COUNT];
+
   struct {
     struct {
       IAChannel ch;
@@ -124,7 +131,7 @@ enum {
 /**
  * S1to2 de-mixer: R2 = 2 x Mono - L2
  * */
-static int dmx_s2(Demixer *ths) {
+static int dmx_s2(Demixer *ths, int b, int e) {
   float *r = 0;
   if (!ths->ch_data[IA_CH_L2]) return IAMF_ERR_INTERNAL;
   if (ths->ch_data[IA_CH_R2]) return 0;
@@ -134,7 +141,7 @@ static int dmx_s2(Demixer *ths) {
 
   r = &ths->large_buffer[ths->frame_size * CH_MX_S_R];
 
-  for (int i = 0; i < ths->frame_size; ++i) {
+  for (int i = b; i < e; ++i) {
     r[i] = 2 * ths->ch_data[IA_CH_MONO][i] - ths->ch_data[IA_CH_L2][i];
   }
 
@@ -149,12 +156,12 @@ static int dmx_s2(Demixer *ths) {
 /**
  * S2to3 de-mixer: L3 = L2 - 0.707 x C and R3 = R2 - 0.707 x C
  * */
-static int dmx_s3(Demixer *ths) {
+static int dmx_s3(Demixer *ths, int b, int e) {
   float *l, *r;
   uint32_t fs = ths->frame_size;
 
   if (ths->ch_data[IA_CH_R3]) return 0;
-  if (dmx_s2(ths)) return IAMF_ERR_INTERNAL;
+  if (dmx_s2(ths, b, e)) return IAMF_ERR_INTERNAL;
   if (!ths->ch_data[IA_CH_C]) return IAMF_ERR_INTERNAL;
 
   ia_logt("---- s2to3 ----");
@@ -162,7 +169,7 @@ static int dmx_s3(Demixer *ths) {
   l = &ths->large_buffer[CH_MX_S_L * fs];
   r = &ths->large_buffer[CH_MX_S_R * fs];
 
-  for (int i = 0; i < fs; i++) {
+  for (int i = b; i < e; i++) {
     l[i] = ths->ch_data[IA_CH_L2][i] - 0.707 * ths->ch_data[IA_CH_C][i];
     r[i] = ths->ch_data[IA_CH_R2][i] - 0.707 * ths->ch_data[IA_CH_C][i];
   }
@@ -182,16 +189,16 @@ static int dmx_s3(Demixer *ths) {
 /**
  * S3to5 de-mixer: Ls = 1/δ(k) x (L3 - L5) and Rs = 1/δ(k) x (R3 - R5)
  * */
-static int dmx_s5(Demixer *ths) {
+static int dmx_s5(Demixer *ths, int b, int e) {
   float *l, *r;
   uint32_t fs = ths->frame_size;
 
   int Typeid = ths->demixing_mode;
   int last_Typeid = ths->last_dmixtypenum;
-  int i = 0;
+  int i = b;
 
   if (ths->ch_data[IA_CH_SR5]) return 0;
-  if (dmx_s3(ths)) return IAMF_ERR_INTERNAL;
+  if (dmx_s3(ths, b, e)) return IAMF_ERR_INTERNAL;
   if (!ths->ch_data[IA_CH_L5] || !ths->ch_data[IA_CH_R5])
     return IAMF_ERR_INTERNAL;
 
@@ -201,14 +208,14 @@ static int dmx_s5(Demixer *ths) {
   l = &ths->large_buffer[CH_MX_S5_L * fs];
   r = &ths->large_buffer[CH_MX_S5_R * fs];
 
-  for (; i < ths->skip; i++) {
+  for (; i < ths->skip && i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_L3][i] - ths->ch_data[IA_CH_L5][i]) /
            demixing_type_mat[last_Typeid].delta;
     r[i] = (ths->ch_data[IA_CH_R3][i] - ths->ch_data[IA_CH_R5][i]) /
            demixing_type_mat[last_Typeid].delta;
   }
 
-  for (; i < fs; i++) {
+  for (; i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_L3][i] - ths->ch_data[IA_CH_L5][i]) /
            demixing_type_mat[Typeid].delta;
     r[i] = (ths->ch_data[IA_CH_R3][i] - ths->ch_data[IA_CH_R5][i]) /
@@ -231,16 +238,16 @@ static int dmx_s5(Demixer *ths) {
  * S5to7 de-mixer: Lrs = 1/β(k) x (Ls - α(k) x Lss) and
  *                 Rrs = 1/β(k) x (Rs - α(k) x Rss)
  * */
-static int dmx_s7(Demixer *ths) {
+static int dmx_s7(Demixer *ths, int b, int e) {
   float *l, *r;
   uint32_t fs = ths->frame_size;
 
-  int i = 0;
+  int i = b;
   int Typeid = ths->demixing_mode;
   int last_Typeid = ths->last_dmixtypenum;
 
   if (ths->ch_data[IA_CH_BR7]) return 0;
-  if (dmx_s5(ths) < 0) return IAMF_ERR_INTERNAL;
+  if (dmx_s5(ths, b, e) < 0) return IAMF_ERR_INTERNAL;
   if (!ths->ch_data[IA_CH_SL7] || !ths->ch_data[IA_CH_SR7])
     return IAMF_ERR_INTERNAL;
 
@@ -250,7 +257,7 @@ static int dmx_s7(Demixer *ths) {
   l = &ths->large_buffer[CH_MX_S_L * fs];
   r = &ths->large_buffer[CH_MX_S_R * fs];
 
-  for (; i < ths->skip; i++) {
+  for (; i < ths->skip && i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_SL5][i] -
             ths->ch_data[IA_CH_SL7][i] * demixing_type_mat[last_Typeid].alpha) /
            demixing_type_mat[last_Typeid].beta;
@@ -259,7 +266,7 @@ static int dmx_s7(Demixer *ths) {
            demixing_type_mat[last_Typeid].beta;
   }
 
-  for (; i < ths->frame_size; i++) {
+  for (; i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_SL5][i] -
             ths->ch_data[IA_CH_SL7][i] * demixing_type_mat[Typeid].alpha) /
            demixing_type_mat[Typeid].beta;
@@ -284,11 +291,11 @@ static int dmx_s7(Demixer *ths) {
  * TF2toT2 de-mixer: Ltf2 = Ltf3 - w(k) x (L3 - L5) and
  *                   Rtf2 = Rtf3 - w(k) x (R3 - R5)
  * */
-static int dmx_h2(Demixer *ths) {
+static int dmx_h2(Demixer *ths, int b, int e) {
   float *l, *r;
   float w, lastW;
   uint32_t fs = ths->frame_size;
-  int i = 0;
+  int i = b;
 
   int Typeid = ths->demixing_mode;
   int last_Typeid = ths->last_dmixtypenum;
@@ -296,7 +303,7 @@ static int dmx_h2(Demixer *ths) {
   if (ths->ch_data[IA_CH_HR]) return 0;
   if (!ths->ch_data[IA_CH_TL] || !ths->ch_data[IA_CH_TR])
     return IAMF_ERR_INTERNAL;
-  if (dmx_s5(ths)) return IAMF_ERR_INTERNAL;
+  if (dmx_s5(ths, b, e)) return IAMF_ERR_INTERNAL;
 
   w = get_w(ths->weight_state_idx);
   lastW = get_w(ths->last_weight_state_idx);
@@ -308,14 +315,14 @@ static int dmx_h2(Demixer *ths) {
   l = &ths->large_buffer[CH_MX_T_L * fs];
   r = &ths->large_buffer[CH_MX_T_R * fs];
 
-  for (; i < ths->skip; i++) {
+  for (; i < ths->skip && i < e; i++) {
     l[i] = ths->ch_data[IA_CH_TL][i] - demixing_type_mat[last_Typeid].delta *
                                            lastW * ths->ch_data[IA_CH_SL5][i];
     r[i] = ths->ch_data[IA_CH_TR][i] - demixing_type_mat[last_Typeid].delta *
                                            lastW * ths->ch_data[IA_CH_SR5][i];
   }
 
-  for (; i < ths->frame_size; i++) {
+  for (; i < e; i++) {
     l[i] = ths->ch_data[IA_CH_TL][i] -
            demixing_type_mat[Typeid].delta * w * ths->ch_data[IA_CH_SL5][i];
     r[i] = ths->ch_data[IA_CH_TR][i] -
@@ -335,15 +342,15 @@ static int dmx_h2(Demixer *ths) {
 /**
  * Ltb = 1/γ(k) x (Ltf2 - Ltf4) and Rtb = 1/γ(k) x (Rtf2 - Rtf4)
  * */
-static int dmx_h4(Demixer *ths) {
+static int dmx_h4(Demixer *ths, int b, int e) {
   float *l, *r;
   uint32_t fs = ths->frame_size;
-  int i = 0;
+  int i = b;
   int Typeid = ths->demixing_mode;
   int last_Typeid = ths->last_dmixtypenum;
 
   if (ths->ch_data[IA_CH_HBR]) return 0;
-  if (dmx_h2(ths)) return IAMF_ERR_INTERNAL;
+  if (dmx_h2(ths, b, e)) return IAMF_ERR_INTERNAL;
   if (!ths->ch_data[IA_CH_HFR] || !ths->ch_data[IA_CH_HFL])
     return IAMF_ERR_INTERNAL;
 
@@ -353,14 +360,14 @@ static int dmx_h4(Demixer *ths) {
   l = &ths->large_buffer[CH_MX_T_L * fs];
   r = &ths->large_buffer[CH_MX_T_R * fs];
 
-  for (; i < ths->skip; i++) {
+  for (; i < ths->skip && i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_HL][i] - ths->ch_data[IA_CH_HFL][i]) /
            demixing_type_mat[last_Typeid].gamma;
     r[i] = (ths->ch_data[IA_CH_HR][i] - ths->ch_data[IA_CH_HFR][i]) /
            demixing_type_mat[last_Typeid].gamma;
   }
 
-  for (; i < ths->frame_size; i++) {
+  for (; i < e; i++) {
     l[i] = (ths->ch_data[IA_CH_HL][i] - ths->ch_data[IA_CH_HFL][i]) /
            demixing_type_mat[Typeid].gamma;
     r[i] = (ths->ch_data[IA_CH_HR][i] - ths->ch_data[IA_CH_HFR][i]) /
@@ -377,7 +384,7 @@ static int dmx_h4(Demixer *ths) {
   return 0;
 }
 
-static int dmx_channel(Demixer *ths, IAChannel ch) {
+static int dmx_channel(Demixer *ths, IAChannel ch, int b, int e) {
   int ret = IAMF_ERR_INTERNAL;
   ia_logt("demix channel %s(%d) pos %p", ia_channel_name(ch), ch,
           ths->ch_data[ch]);
@@ -390,27 +397,27 @@ static int dmx_channel(Demixer *ths, IAChannel ch) {
 
   switch (ch) {
     case IA_CH_R2:
-      ret = dmx_s2(ths);
+      ret = dmx_s2(ths, b, e);
       break;
     case IA_CH_L3:
     case IA_CH_R3:
-      ret = dmx_s3(ths);
+      ret = dmx_s3(ths, b, e);
       break;
     case IA_CH_SL5:
     case IA_CH_SR5:
-      ret = dmx_s5(ths);
+      ret = dmx_s5(ths, b, e);
       break;
     case IA_CH_BL7:
     case IA_CH_BR7:
-      ret = dmx_s7(ths);
+      ret = dmx_s7(ths, b, e);
       break;
     case IA_CH_HL:
     case IA_CH_HR:
-      ret = dmx_h2(ths);
+      ret = dmx_h2(ths, b, e);
       break;
     case IA_CH_HBL:
     case IA_CH_HBR:
-      ret = dmx_h4(ths);
+      ret = dmx_h4(ths, b, e);
       break;
     default:
       break;
@@ -418,59 +425,76 @@ static int dmx_channel(Demixer *ths, IAChannel ch) {
   return ret;
 }
 
-static void dmx_gainup(Demixer *ths) {
+static void dmx_gainup(Demixer *ths, int b, int e) {
   for (int c = 0; c < ths->chs_gain_list.count; ++c) {
-    for (int i = 0; i < ths->frame_size; ++i) {
-      if (ths->ch_data[ths->chs_gain_list.ch_gain[c].ch]) {
-        ths->ch_data[ths->chs_gain_list.ch_gain[c].ch][i] *=
-            ths->chs_gain_list.ch_gain[c].gain;
-      }
-    }
+    float *data = ths->ch_data[ths->chs_gain_list.ch_gain[c].ch];
+    float gain = ths->chs_gain_list.ch_gain[c].gain;
+    if (!data) continue;
+    for (int i = b; i < e; ++i) data[i] *= gain;
   }
 }
 
-static int dmx_demix(Demixer *ths) {
+static int dmx_demix(Demixer *ths, int b, int e) {
   int chcnt = ia_channel_layout_get_channels_count(ths->layout);
 
   for (int c = 0; c < chcnt; ++c) {
-    if (dmx_channel(ths, ths->chs_out[c]) < 0) {
+    if (!(ths->output_mask & RSHIFT(c))) continue;
+    if (dmx_channel(ths, ths->chs_out[c], b, e) < 0) {
       return IAMF_ERR_INTERNAL;
     }
   }
   return IAMF_OK;
 }
 
-static void dmx_rms(Demixer *ths) {
-  float N = 7;  // 7 frame
-  float sf, sfavg;
+static void dmx_rms(Demixer *ths, float *sfavg, int b, int e) {
   float filtBuf;
   float *out;
   IAChannel ch;
 
+  for (int c = 0; c < ths->chs_recon_gain_list.count; c++) {
+    ch = ths->chs_recon_gain_list.ch_recon_gain[c].ch;
+    out = ths->ch_data[ch];
+    if (ths->chs_unused[ch]) continue;
+
+    /* different scale factor in overapping area */
+    for (int i = b; i < e; i++) {
+      filtBuf = ths->ch_last_sfavg[ch] * ths->stop_window[i] +
+                sfavg[c] * ths->start_window[i];
+      out[i] *= filtBuf;
+    }
+  }
+}
+
+static void dmx_rms_smooth(Demixer *ths, float *sfavg) {
+  float N = 7;  // 7 frame
+  float sf;
+  IAChannel ch;
+
   ia_logt("---- demixer_equalizeRMS ----");
 
   for (int c = 0; c < ths->chs_recon_gain_list.count; c++) {
     ch = ths->chs_recon_gain_list.ch_recon_gain[c].ch;
     sf = ths->chs_recon_gain_list.ch_recon_gain[c].recon_gain;
-    out = ths->ch_data[ch];
 
     if (N > 0) {
-      sfavg = (2 / (N + 1)) * sf + (1 - 2 / (N + 1)) * ths->ch_last_sfavg[ch];
+      sfavg[c] =
+          (2 / (N + 1)) * sf + (1 - 2 / (N + 1)) * ths->ch_last_sfavg[ch];
     } else {
-      sfavg = sf;
+      sfavg[c] = sf;
     }
 
     ia_logd("channel %s(%d) is smoothed within %f.", ia_channel_name(ch), ch,
             sf);
-    /* different scale factor in overapping area */
-    for (int i = 0; i < ths->frame_size; i++) {
-      filtBuf = ths->ch_last_sfavg[ch] * ths->stop_window[i] +
-                sfavg * ths->start_window[i];
-      out[i] *= filtBuf;
-    }
+  }
+}
+
+static void dmx_rms_update(Demixer *ths, float *sfavg) {
+  IAChannel ch;
 
-    ths->ch_last_sf[ch] = sf;
-    ths->ch_last_sfavg[ch] = sfavg;
+  for (int c = 0; c < ths->chs_recon_gain_list.count; c++) {
+    ch = ths->chs_recon_gain_list.ch_recon_gain[c].ch;
+    ths->ch_last_sf[ch] = ths->chs_recon_gain_list.ch_recon_gain[c].recon_gain;
+    ths->ch_last_sfavg[ch] = sfavg[c];
   }
 }
 
@@ -483,6 +507,7 @@ Demixer *demixer_open(uint32_t frame_size) {
 
     ths->frame_size = frame_size;
     ths->layout = IA_CHANNEL_LAYOUT_INVALID;
+    ths->output_mask = UINT32_MAX;
 
     ths->hanning_filter = IAMF_MALLOC(float, windowLen);
     ths->start_window = IAMF_MALLOC(float, frame_size);
@@ -562,15 +587,35 @@ int demixer_set_frame_offset(Demixer *ths, uint32_t offset) {
   return IAMF_OK;
 }
 
+static void dmx_update_unused_channels(Demixer *ths) {
+  int chcnt = ia_channel_layout_get_channels_count(ths->layout);
+
+  memset(ths->chs_unused, 0, sizeof(ths->chs_unused));
+  for (int c = 0; c < chcnt; ++c) {
+    if (!(ths->output_mask & RSHIFT(c))) {
+      ths->chs_unused[ths->chs_out[c]] = 1;
+      ia_logd("channel %s(%d) is not demixed.",
+              ia_channel_name(ths->chs_out[c]), ths->chs_out[c]);
+    }
+  }
+}
+
 int demixer_set_channel_layout(Demixer *ths, IAChannelLayoutType layout) {
   if (ia_channel_layout_get_channels(layout, ths->chs_out,
                                      IA_CH_LAYOUT_MAX_CHANNELS) > 0) {
     ths->layout = layout;
+    dmx_update_unused_channels(ths);
     return IAMF_OK;
   }
   return IAMF_ERR_BAD_ARG;
 }
 
+int demixer_set_output_mask(Demixer *ths, uint32_t mask) {
+  ths->output_mask = mask;
+  if (ths->layout != IA_CHANNEL_LAYOUT_INVALID) dmx_update_unused_channels(ths);
+  return IAMF_OK;
+}
+
 int demixer_set_channels_order(Demixer *ths, IAChannel *chs, int count) {
   memcpy(ths->chs_in, chs, sizeof(IAChannel) * count);
   ths->chs_count = count;
@@ -633,32 +678,50 @@ int demixer_set_recon_gain(Demixer *ths, int count, IAChannel *chs,
   return IAMF_OK;
 }
 
+/**
+ * The output gain, the demixing, the smoothing of recon gain and the output
+ * are done block by block, so the channels of a block stay in cache.
+ * */
 int demixer_demixing(Demixer *ths, float *dst, float *src, uint32_t size) {
+  float sfavg[IA_CH_RE_COUNT];
   IAChannel ch;
+  int e;
 
   if (size != ths->frame_size) return IAMF_ERR_BAD_ARG;
   if (ia_channel_layout_get_channels_count(ths->layout) != ths->chs_count)
     return IAMF_ERR_INTERNAL;
 
-  memset(ths->ch_data, 0, sizeof(float *) * IA_CH_COUNT);
-  for (int c = 0; c < ths->chs_count; ++c) {
-    ths->ch_data[ths->chs_in[c]] = src + size * c;
-  }
+  dmx_rms_smooth(ths, sfavg);
+
+  for (int b = 0; b < size; b = e) {
+    e = b + DMX_BLOCK_SIZE < size ? b + DMX_BLOCK_SIZE : size;
 
-  dmx_gainup(ths);
-  if (dmx_demix(ths) < 0) return IAMF_ERR_INTERNAL;
-  dmx_rms(ths);
+    memset(ths->ch_data, 0, sizeof(float *) * IA_CH_COUNT);
+    for (int c = 0; c < ths->chs_count; ++c) {
+      ths->ch_data[ths->chs_in[c]] = src + size * c;
+    }
+
+    dmx_gainup(ths, b, e);
+    if (dmx_demix(ths, b, e) < 0) return IAMF_ERR_INTERNAL;
+    dmx_rms(ths, sfavg, b, e);
 
-  for (int c = 0; c < ths->chs_count; ++c) {
-    ch = ths->chs_out[c];
-    if (!ths->ch_data[ch]) {
-      ia_loge("channel %s(%d) doesn't has data.", ia_channel_name(ch), ch);
-      continue;
+    for (int c = 0; c < ths->chs_count; ++c) {
+      ch = ths->chs_out[c];
+      if (ths->chs_unused[ch]) {
+        memset(&dst[c * size + b], 0, sizeof(float) * (e - b));
+        continue;
+      }
+      if (!ths->ch_data[ch]) {
+        if (!b)
+          ia_loge("channel %s(%d) doesn't has data.", ia_channel_name(ch), ch);
+        continue;
+      }
+      memcpy(&dst[c * size + b], &ths->ch_data[ch][b],
+             sizeof(float) * (e - b));
     }
-    ia_logt("output channel %s(%d) at %p", ia_channel_name(ch), ch,
-            ths->ch_data[ch]);
-    memcpy((void *)&dst[c * size], (void *)ths->ch_data[ch],
-           sizeof(float) * size);
   }
+
+  dmx_rms_update(ths, sfavg);
+
   return IAMF_OK;
 }
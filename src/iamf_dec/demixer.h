@@ -51,6 +51,7 @@ int demixer_set_channels_order(Demixer *, IAChannel *, int);
 int demixer_set_output_gain(Demixer *, IAChannel *, float *, int);
 int demixer_set_demixing_info(Demixer *, int, int);
 int demixer_set_recon_gain(Demixer *, int, IAChannel *, float *, uint32_t);
+int demixer_set_output_mask(Demixer *, uint32_t);
 int demixer_demixing(Demixer *, float *, float *, uint32_t);
 
 #endif /* __DEMIXER_H_ */
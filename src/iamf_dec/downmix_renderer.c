@@ -42,8 +42,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "IAMF_debug.h"
 #include "IAMF_utils.h"
+#include "ae_rdr.h"
 #include "fixedp11_5.h"
 
+#define DOWNMIX_DEPEND_CHANNELS 11
+
 typedef struct DependOnChannel {
   IAChannel ch;
   float s;
@@ -57,22 +60,40 @@ struct Downmixer {
   IAChannel chs_out[IA_CH_LAYOUT_MAX_CHANNELS];
   int chs_icount;
   int chs_ocount;
-  float *chs_data[IA_CH_COUNT];
+  // the index of the input channel, or -1.
+  int chs_index[IA_CH_COUNT];
   DependOnChannel *deps[IA_CH_COUNT];
+  DependOnChannel dep_chs[DOWNMIX_DEPEND_CHANNELS][3];
   MixFactors mix_factors;
+
+  // the dependencies flattened to the input taps of each output channel.
+  struct rdr_sparse_t matrix;
+  int offsets[IA_CH_LAYOUT_MAX_CHANNELS + 1];
+  struct rdr_tap_t taps[IA_CH_LAYOUT_MAX_CHANNELS * IA_CH_LAYOUT_MAX_CHANNELS];
 };
 
-static DependOnChannel chmono[] = {{IA_CH_R2, 0.5f}, {IA_CH_L2, 0.5}, {0}};
-static DependOnChannel chl2[] = {{IA_CH_L3, 1.f}, {IA_CH_C, 0.707}, {0}};
-static DependOnChannel chr2[] = {{IA_CH_R3, 1.f}, {IA_CH_C, 0.707}, {0}};
-static DependOnChannel chtl[] = {{IA_CH_HL, 1.f}, {IA_CH_SL5}, {0}};
-static DependOnChannel chtr[] = {{IA_CH_HR, 1.f}, {IA_CH_SR5}, {0}};
-static DependOnChannel chl3[] = {{IA_CH_L5, 1.f}, {IA_CH_SL5}, {0}};
-static DependOnChannel chr3[] = {{IA_CH_R5, 1.f}, {IA_CH_SR5}, {0}};
-static DependOnChannel chsl5[] = {{IA_CH_SL7}, {IA_CH_BL7}, {0}};
-static DependOnChannel chsr5[] = {{IA_CH_SR7}, {IA_CH_BR7}, {0}};
-static DependOnChannel chhl[] = {{IA_CH_HFL, 1.f}, {IA_CH_HBL}, {0}};
-static DependOnChannel chhr[] = {{IA_CH_HFR, 1.f}, {IA_CH_HBR}, {0}};
+static const DependOnChannel chmono[] = {{IA_CH_R2, 0.5f},
+                                         {IA_CH_L2, 0.5},
+                                         {0}};
+static const DependOnChannel chl2[] = {{IA_CH_L3, 1.f}, {IA_CH_C, 0.707}, {0}};
+static const DependOnChannel chr2[] = {{IA_CH_R3, 1.f}, {IA_CH_C, 0.707}, {0}};
+static const DependOnChannel chtl[] = {{IA_CH_HL, 1.f}, {IA_CH_SL5}, {0}};
+static const DependOnChannel chtr[] = {{IA_CH_HR, 1.f}, {IA_CH_SR5}, {0}};
+static const DependOnChannel chl3[] = {{IA_CH_L5, 1.f}, {IA_CH_SL5}, {0}};
+static const DependOnChannel chr3[] = {{IA_CH_R5, 1.f}, {IA_CH_SR5}, {0}};
+static const DependOnChannel chsl5[] = {{IA_CH_SL7}, {IA_CH_BL7}, {0}};
+static const DependOnChannel chsr5[] = {{IA_CH_SR7}, {IA_CH_BR7}, {0}};
+static const DependOnChannel chhl[] = {{IA_CH_HFL, 1.f}, {IA_CH_HBL}, {0}};
+static const DependOnChannel chhr[] = {{IA_CH_HFR, 1.f}, {IA_CH_HBR}, {0}};
+
+static const struct {
+  IAChannel ch;
+  const DependOnChannel *deps;
+} dep_chs[DOWNMIX_DEPEND_CHANNELS] = {
+    {IA_CH_MONO, chmono}, {IA_CH_L2, chl2},   {IA_CH_R2, chr2},
+    {IA_CH_L3, chl3},     {IA_CH_R3, chr3},   {IA_CH_SL5, chsl5},
+    {IA_CH_SR5, chsr5},   {IA_CH_TL, chtl},   {IA_CH_TR, chtr},
+    {IA_CH_HL, chhl},     {IA_CH_HR, chhr}};
 
 static int _valid_channel_layout(IAChannelLayoutType in) {
   return ia_channel_layout_type_check(in) && in != IA_CHANNEL_LAYOUT_BINAURAL;
@@ -92,7 +113,7 @@ static int _valid_downmix(IAChannelLayoutType in, IAChannelLayoutType out) {
 
 static void _downmix_dump(DMRenderer *thisp, IAChannel c) {
   DependOnChannel *cs = thisp->deps[c];
-  if (thisp->chs_data[c]) return;
+  if (thisp->chs_index[c] >= 0) return;
   if (!thisp->deps[c]) {
     ia_loge("channel %s(%d) can not be found.", ia_channel_name(c), c);
     return;
@@ -101,31 +122,70 @@ static void _downmix_dump(DMRenderer *thisp, IAChannel c) {
   while (cs->ch) {
     if (cs->sp) {
       ia_logd("channel %s(%d), scale point %f%s", ia_channel_name(cs->ch),
-              cs->ch, *cs->sp, thisp->chs_data[cs->ch] ? ", s." : " m.");
+              cs->ch, *cs->sp, thisp->chs_index[cs->ch] >= 0 ? ", s." : " m.");
       _downmix_dump(thisp, cs->ch);
     } else {
       ia_logd("channel %s(%d), scale %f%s", ia_channel_name(cs->ch), cs->ch,
-              cs->s, thisp->chs_data[cs->ch] ? ", s." : " m.");
+              cs->s, thisp->chs_index[cs->ch] >= 0 ? ", s." : " m.");
       _downmix_dump(thisp, cs->ch);
     }
     ++cs;
   }
 }
 
-static float _downmix_channel_data(DMRenderer *thisp, IAChannel c, int i) {
+static void _downmix_flatten(DMRenderer *thisp, IAChannel c, float scale,
+                             float *row) {
   DependOnChannel *cs = thisp->deps[c];
-  float sum = 0.f;
-  if (thisp->chs_data[c]) return thisp->chs_data[c][i];
-  if (!thisp->deps[c]) return 0.f;
+  if (thisp->chs_index[c] >= 0) {
+    row[thisp->chs_index[c]] += scale;
+    return;
+  }
+  if (!thisp->deps[c]) return;
 
   while (cs->ch) {
     if (cs->sp)
-      sum += _downmix_channel_data(thisp, cs->ch, i) * (*cs->sp);
+      _downmix_flatten(thisp, cs->ch, scale * (*cs->sp), row);
     else
-      sum += _downmix_channel_data(thisp, cs->ch, i) * cs->s;
+      _downmix_flatten(thisp, cs->ch, scale * cs->s, row);
+    ++cs;
+  }
+}
+
+static void _downmix_demand(DMRenderer *thisp, IAChannel c, uint32_t *mask) {
+  DependOnChannel *cs = thisp->deps[c];
+  if (thisp->chs_index[c] >= 0) {
+    *mask |= RSHIFT(thisp->chs_index[c]);
+    return;
+  }
+  if (!thisp->deps[c]) return;
+
+  while (cs->ch) {
+    _downmix_demand(thisp, cs->ch, mask);
     ++cs;
   }
-  return sum;
+}
+
+/* resolves the coefficients of the input channels for each output channel. */
+static void _downmix_update(DMRenderer *thisp) {
+  float row[IA_CH_LAYOUT_MAX_CHANNELS];
+  int count = 0;
+
+  for (int i = 0; i < thisp->chs_ocount; ++i) {
+    ia_logd("channel %s(%d) checking...", ia_channel_name(thisp->chs_out[i]),
+            thisp->chs_out[i]);
+    _downmix_dump(thisp, thisp->chs_out[i]);
+
+    memset(row, 0, sizeof(row));
+    _downmix_flatten(thisp, thisp->chs_out[i], 1.f, row);
+    thisp->offsets[i] = count;
+    for (int k = 0; k < thisp->chs_icount; ++k) {
+      if (row[k] == 0.f) continue;
+      thisp->taps[count].input = k;
+      thisp->taps[count].gain = row[k];
+      ++count;
+    }
+  }
+  thisp->offsets[thisp->chs_ocount] = count;
 }
 
 DMRenderer *DMRenderer_open(IAChannelLayoutType in, IAChannelLayoutType out) {
@@ -149,17 +209,11 @@ DMRenderer *DMRenderer_open(IAChannelLayoutType in, IAChannelLayoutType out) {
   thisp->mode = -1;
   thisp->w_idx = -1;
 
-  thisp->deps[IA_CH_MONO] = chmono;
-  thisp->deps[IA_CH_L2] = chl2;
-  thisp->deps[IA_CH_R2] = chr2;
-  thisp->deps[IA_CH_L3] = chl3;
-  thisp->deps[IA_CH_R3] = chr3;
-  thisp->deps[IA_CH_SL5] = chsl5;
-  thisp->deps[IA_CH_SR5] = chsr5;
-  thisp->deps[IA_CH_TL] = chtl;
-  thisp->deps[IA_CH_TR] = chtr;
-  thisp->deps[IA_CH_HL] = chhl;
-  thisp->deps[IA_CH_HR] = chhr;
+  // each renderer owns its dependencies, scale points refer to its factors.
+  for (int i = 0; i < DOWNMIX_DEPEND_CHANNELS; ++i) {
+    memcpy(thisp->dep_chs[i], dep_chs[i].deps, sizeof(thisp->dep_chs[i]));
+    thisp->deps[dep_chs[i].ch] = thisp->dep_chs[i];
+  }
 
   thisp->deps[IA_CH_SR5][0].sp = thisp->deps[IA_CH_SL5][0].sp =
       &thisp->mix_factors.alpha;
@@ -170,7 +224,15 @@ DMRenderer *DMRenderer_open(IAChannelLayoutType in, IAChannelLayoutType out) {
   thisp->deps[IA_CH_HL][1].sp = thisp->deps[IA_CH_HR][1].sp =
       &thisp->mix_factors.gamma;
 
-  for (int i = 0; i < thisp->chs_icount; ++i) thisp->deps[thisp->chs_in[i]] = 0;
+  for (int i = 0; i < IA_CH_COUNT; ++i) thisp->chs_index[i] = -1;
+  for (int i = 0; i < thisp->chs_icount; ++i) {
+    thisp->deps[thisp->chs_in[i]] = 0;
+    thisp->chs_index[thisp->chs_in[i]] = i;
+  }
+
+  thisp->matrix.offsets = thisp->offsets;
+  thisp->matrix.taps = thisp->taps;
+  _downmix_update(thisp);
 
   return thisp;
 }
@@ -178,9 +240,12 @@ DMRenderer *DMRenderer_open(IAChannelLayoutType in, IAChannelLayoutType out) {
 void DMRenderer_close(DMRenderer *thisp) { IAMF_FREE(thisp); }
 
 int DMRenderer_set_mode_weight(DMRenderer *thisp, int mode, int w_idx) {
+  int update = 0;
+
   if (!thisp || !iamf_valid_mix_mode(mode)) return IAMF_ERR_BAD_ARG;
 
   if (thisp->mode != mode) {
+    update = 1;
     ia_logd("dmixtypenum: %d -> %d", thisp->mode, mode);
     thisp->mode = mode;
     thisp->mix_factors = *iamf_get_mix_factors(mode);
@@ -196,6 +261,7 @@ int DMRenderer_set_mode_weight(DMRenderer *thisp, int mode, int w_idx) {
     calc_w(thisp->mix_factors.w_idx_offset, thisp->w_idx, &new_w_idx);
     ia_logd("weight state index : %d (%f) -> %d (%f)", thisp->w_idx,
             get_w(thisp->w_idx), new_w_idx, get_w(new_w_idx));
+    if (thisp->w_idx != new_w_idx) update = 1;
     thisp->w_idx = new_w_idx;
     if (thisp->deps[IA_CH_TL] && thisp->deps[IA_CH_TR])
       thisp->deps[IA_CH_TL][1].s = thisp->deps[IA_CH_TR][1].s =
@@ -203,6 +269,7 @@ int DMRenderer_set_mode_weight(DMRenderer *thisp, int mode, int w_idx) {
   } else {
     if (mode != thisp->mode) ia_logd("set default demixing mode %d", mode);
     if (thisp->w_idx != w_idx) {
+      update = 1;
       thisp->w_idx = w_idx;
       ia_logd("set default weight index %d, value %f", w_idx, get_w(w_idx));
       if (thisp->deps[IA_CH_TL] && thisp->deps[IA_CH_TR]) {
@@ -212,31 +279,36 @@ int DMRenderer_set_mode_weight(DMRenderer *thisp, int mode, int w_idx) {
     }
   }
 
+  if (update) _downmix_update(thisp);
+
   return IAMF_OK;
 }
 
 int DMRenderer_downmix(DMRenderer *thisp, float *in, float *out, uint32_t s,
                        uint32_t duration, uint32_t size) {
-  int off, e;
-  if (!thisp || !in || !out || !size || s >= size) return IAMF_ERR_BAD_ARG;
+  float *ins[IA_CH_LAYOUT_MAX_CHANNELS];
+  float *outs[IA_CH_LAYOUT_MAX_CHANNELS];
+  uint32_t e;
 
-  memset(thisp->chs_data, 0, IA_CH_COUNT * sizeof(float));
-  for (int i = 0; i < thisp->chs_icount; ++i) {
-    thisp->chs_data[thisp->chs_in[i]] = in + size * i;
-  }
+  if (!thisp || !in || !out || !size || s >= size) return IAMF_ERR_BAD_ARG;
 
   e = s + duration;
   if (e > size) e = size;
 
-  for (int i = 0; i < thisp->chs_ocount; ++i) {
-    ia_logd("channel %s(%d) checking...", ia_channel_name(thisp->chs_out[i]),
-            thisp->chs_out[i]);
-    _downmix_dump(thisp, thisp->chs_out[i]);
-    off = size * i;
-    for (int j = s; j < e; ++j) {
-      out[off + j] = _downmix_channel_data(thisp, thisp->chs_out[i], j);
-    }
-  }
+  for (int i = 0; i < thisp->chs_icount; ++i) ins[i] = in + size * i + s;
+  for (int i = 0; i < thisp->chs_ocount; ++i) outs[i] = out + size * i + s;
+
+  IAMF_element_renderer_render_sparse(&thisp->matrix, ins, outs,
+                                      thisp->chs_ocount, e - s);
 
   return IAMF_OK;
 }
+
+/* the input channels which the output channels depend on in any mode. */
+uint32_t DMRenderer_get_input_mask(DMRenderer *thisp) {
+  uint32_t mask = 0;
+  if (!thisp) return 0;
+  for (int i = 0; i < thisp->chs_ocount; ++i)
+    _downmix_demand(thisp, thisp->chs_out[i], &mask);
+  return mask;
+}
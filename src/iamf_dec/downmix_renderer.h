@@ -47,5 +47,6 @@ void DMRenderer_close(DMRenderer *);
 int DMRenderer_set_mode_weight(DMRenderer *, int, int);
 int DMRenderer_downmix(DMRenderer *, float *, float *, uint32_t, uint32_t,
                        uint32_t);
+uint32_t DMRenderer_get_input_mask(DMRenderer *);
 
 #endif /* __DOWNMIX_RENDERER_H_ */
@@ -51,8 +51,6 @@ static int iamf_flac_close(IAMF_CodecContext *ths);
 
 typedef struct IAMF_FLAC_Context {
   FLACMSDecoder *dec;
-  int *out;
-  float scale_i2f;
 } IAMF_FLAC_Context;
 
 static int iamf_flac_init(IAMF_CodecContext *ths) {
@@ -77,16 +75,7 @@ static int iamf_flac_init(IAMF_CodecContext *ths) {
     iamf_flac_close(ths);
     return IAMF_ERR_INTERNAL;
   }
-
-  ctx->scale_i2f = 1 << (bits - 1);
-  ia_logd("the scale of i%d to float : %f", bits, ctx->scale_i2f);
-
-  ctx->out = IAMF_MALLOC(
-      int, MAX_FLAC_FRAME_SIZE *(ths->streams + ths->coupled_streams));
-  if (!ctx->out) {
-    iamf_flac_close(ths);
-    return IAMF_ERR_ALLOC_FAIL;
-  }
+  ia_logd("sample bits %d.", bits);
 
   return IAMF_OK;
 }
@@ -96,22 +85,13 @@ static int iamf_flac_decode(IAMF_CodecContext *ths, uint8_t *buffer[],
                             uint32_t frame_size) {
   IAMF_FLAC_Context *ctx = (IAMF_FLAC_Context *)ths->priv;
   FLACMSDecoder *dec = (FLACMSDecoder *)ctx->dec;
-  int ret = IAMF_OK;
 
   if (count != ths->streams) {
     return IAMF_ERR_BAD_ARG;
   }
 
-  ret = flac_multistream_decode(dec, buffer, size, ctx->out, frame_size);
-  if (ret > 0) {
-    float *out = (float *)pcm;
-    uint32_t samples = ret * (ths->streams + ths->coupled_streams);
-    for (int i = 0; i < samples; ++i) {
-      out[i] = ctx->out[i] / ctx->scale_i2f;
-    }
-  }
-
-  return ret;
+  return flac_multistream_decode(dec, buffer, size, pcm, frame_size,
+                                 ths->pool);
 }
 
 int iamf_flac_close(IAMF_CodecContext *ths) {
@@ -122,9 +102,6 @@ int iamf_flac_close(IAMF_CodecContext *ths) {
     flac_multistream_decoder_close(dec);
     ctx->dec = 0;
   }
-  if (ctx->out) {
-    free(ctx->out);
-  }
 
   return IAMF_OK;
 }
@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IAMF_types.h"
 #include "IAMF_utils.h"
 #include "bitstream.h"
+#include "sample_convert.h"
 
 #ifdef IA_TAG
 #undef IA_TAG
@@ -50,8 +51,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IA_TAG "FLACMS"
 
-#define MAX_BUFFER_SIZE MAX_FLAC_FRAME_SIZE * 2
-
 typedef struct FLACDecoderHandle {
   FLAC__StreamDecoder *dec;
   struct {
@@ -62,7 +61,12 @@ typedef struct FLACDecoderHandle {
   uint8_t *packet;
   uint32_t packet_size;
   uint32_t fs;
-  int buffer[MAX_FLAC_FRAME_SIZE];
+  int status;
+
+  // the planes of the substream, they are stride samples apart.
+  float *out;
+  uint32_t stride;
+  float scale;
 } FLACDecoderHandle;
 
 typedef struct FLACMSDecoder {
@@ -77,11 +81,12 @@ static FLAC__StreamDecoderReadStatus flac_stream_read(
     const FLAC__StreamDecoder *decoder, FLAC__byte buffer[], size_t *bytes,
     void *client_data) {
   FLACDecoderHandle *handle = (FLACDecoderHandle *)client_data;
-  if (handle->packet) {
+  if (handle->packet && handle->packet_size) {
     ia_logt("read stream %d data", handle->packet_size);
-    memcpy(buffer, handle->packet, handle->packet_size);
-    *bytes = handle->packet_size;
-    handle->packet = 0;
+    if (*bytes > handle->packet_size) *bytes = handle->packet_size;
+    memcpy(buffer, handle->packet, *bytes);
+    handle->packet += *bytes;
+    handle->packet_size -= *bytes;
     return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
   } else {
     ia_loge("The data is incomplete.");
@@ -94,17 +99,20 @@ static FLAC__StreamDecoderWriteStatus flac_stream_write(
     const FLAC__StreamDecoder *decoder, const FLAC__Frame *frame,
     const FLAC__int32 *const buffer[], void *client_data) {
   FLACDecoderHandle *handle = (FLACDecoderHandle *)client_data;
-  char *out = (char *)handle->buffer;
-  int fss = 0;
 
   handle->fs = frame->header.blocksize;
-  fss = handle->fs * sizeof(FLAC__int32);
-
-  for (int i = 0; i < handle->stream_info.channels; ++i) {
-    memcpy(out, (void *)buffer[i], fss);
-    out += fss;
+  if (!handle->out || handle->fs > handle->stride ||
+      frame->header.channels != handle->stream_info.channels) {
+    ia_loge("frame size %u (%u), channels %u (%u).", handle->fs,
+            handle->stride, frame->header.channels,
+            handle->stream_info.channels);
+    return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
   }
 
+  for (int i = 0; i < handle->stream_info.channels; ++i)
+    sample_convert_int2float(handle->out + handle->stride * i, buffer[i],
+                             handle->fs, handle->scale);
+
   return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
 
@@ -116,6 +124,8 @@ static void flac_stream_metadata(const FLAC__StreamDecoder *decoder,
     handle->stream_info.depth = metadata->data.stream_info.bits_per_sample;
     handle->stream_info.channels = metadata->data.stream_info.channels;
     handle->stream_info.sample_rate = metadata->data.stream_info.sample_rate;
+    if (handle->stream_info.depth > 0)
+      handle->scale = 1.f / (1u << (handle->stream_info.depth - 1));
     ia_logi("depth %d, channels %d, sample_rate %d.", handle->stream_info.depth,
             handle->stream_info.channels, handle->stream_info.sample_rate);
   }
@@ -153,29 +163,54 @@ static int flac_header_set_channels(uint8_t *h, uint32_t size, int n) {
   return IAMF_OK;
 }
 
+static void flac_multistream_decode_task(void *arg, int i) {
+  FLACMSDecoder *st = (FLACMSDecoder *)arg;
+  FLACDecoderHandle *handle = &st->handles[i];
+
+  ia_logt("stream %d", i);
+  handle->status = FLAC__stream_decoder_process_single(handle->dec)
+                       ? IAMF_OK
+                       : IAMF_ERR_INTERNAL;
+}
+
 static int flac_multistream_decode_native(FLACMSDecoder *st, uint8_t *buffer[],
                                           uint32_t size[], void *pcm,
-                                          int frame_size) {
+                                          int frame_size, ThreadPool *pool) {
   FLACDecoderHandle *handle = NULL;
-  char *out = (char *)pcm;
-  int ss = 0;
+  float *out = (float *)pcm;
+  float *in;
+
+  if (frame_size <= 0) return IAMF_ERR_BAD_ARG;
 
+  // each substream is decoded into its planes of frame_size samples.
   for (int i = 0; i < st->streams; ++i) {
-    ia_logt("stream %d", i);
     handle = &st->handles[i];
     handle->packet = buffer[i];
     handle->packet_size = size[i];
+    handle->out = out;
+    handle->stride = frame_size;
+    out += frame_size * handle->stream_info.channels;
+  }
+  thread_pool_run(pool, flac_multistream_decode_task, st, st->streams);
+
+  // the planes are packed if the frames are shorter than frame_size.
+  out = (float *)pcm;
 
-    if (!FLAC__stream_decoder_process_single(handle->dec)) {
-      return IAMF_ERR_INTERNAL;
+  for (int i = 0; i < st->streams; ++i) {
+    handle = &st->handles[i];
+    if (handle->status != IAMF_OK) {
+      return handle->status;
     }
 
     if (handle->fs != frame_size)
       ia_logw("Different frame size %d vs %d", frame_size, handle->fs);
 
-    ss = handle->fs * handle->stream_info.channels * 4;
-    memcpy(out, handle->buffer, ss);
-    out += ss;
+    in = handle->out;
+    for (int c = 0; c < handle->stream_info.channels; ++c) {
+      if (in != out) memmove(out, in, sizeof(float) * handle->fs);
+      in += frame_size;
+      out += handle->fs;
+    }
   }
   if (!handle) {
     return IAMF_ERR_BAD_ARG;
@@ -255,11 +290,20 @@ FLACMSDecoder *flac_multistream_decoder_open(uint8_t *config, uint32_t size,
       break;
     }
 
+    // libFLAC allocates its frame buffers when it decodes the first frame,
+    // which is the only allocation of the decoding after configuration.
     if (!FLAC__stream_decoder_process_until_end_of_metadata(handle->dec)) {
       ia_loge("Failed to read meta.");
       ret = IAMF_ERR_INTERNAL;
       break;
     }
+
+    if (handle->stream_info.channels != (i < coupled_streams ? 2 : 1)) {
+      ia_loge("stream %d : invalid channels %u.", i,
+              handle->stream_info.channels);
+      ret = IAMF_ERR_BAD_ARG;
+      break;
+    }
   }
 
   if (ret < 0) {
@@ -276,9 +320,11 @@ FLACMSDecoder *flac_multistream_decoder_open(uint8_t *config, uint32_t size,
 }
 
 int flac_multistream_decode(FLACMSDecoder *st, uint8_t *buffer[],
-                            uint32_t size[], void *pcm, uint32_t frame_size) {
+                            uint32_t size[], void *pcm, uint32_t frame_size,
+                            ThreadPool *pool) {
   if (st->flags & AUDIO_FRAME_PLANE)
-    return flac_multistream_decode_native(st, buffer, size, pcm, frame_size);
+    return flac_multistream_decode_native(st, buffer, size, pcm, frame_size,
+                                          pool);
   else {
     return IAMF_ERR_UNIMPLEMENTED;
   }
@@ -999,7 +999,7 @@ float toa_iamf712[][16] = {
      -5.936060e-02, -1.568681e-01, -5.580345e-02, 2.531912e-02, 1.216808e-03,
      -8.005355e-03}};
 
-struct h2m_rdr_t h2m_rdr_tab[] = {
+static const struct h2m_rdr_t h2m_rdr_tab[] = {
     {IAMF_ZOA, BS2051_A, 2, -1, -1, (float *)zoa_bs020, 1, 2},
     {IAMF_ZOA, BS2051_B, 6, 3, -1, (float *)zoa_bs050, 1, 5},
     {IAMF_ZOA, BS2051_C, 8, 3, -1, (float *)zoa_bs250, 1, 7},
@@ -1085,114 +1085,76 @@ static float lfefilter_update(lfe_filter_t *lfe_f, float input);
 #endif
 
 // HOA to Multichannel Renderer
-int IAMF_element_renderer_render_H2M(struct h2m_rdr_t *h2mMatrix, float *in[],
+int IAMF_element_renderer_render_H2M(struct h2m_rdr_t *h2mMatrix,
+                                     struct rdr_sparse_t *sparse, float *in[],
                                      float *out[], int nsamples,
                                      lfe_filter_t *lfe) {
-  int i, j, m, n;
+  int i, n;
   int m_size = h2mMatrix->m;
   int n_size = h2mMatrix->n;
 
   // lfe generator turns on
   int lfe1 = h2mMatrix->lfe1;
   int lfe2 = h2mMatrix->lfe2;
-  int map[24] = {
-      0,
-  };
 
   /// convert HOA to channel by using the predefined matrix
-  for (i = 0; i < nsamples; i++) {
-    for (n = 0; n < n_size; n++) {    // output
-      for (m = 0; m < m_size; m++) {  // input
-        if (m == 0) {
-          out[n][i] = 0;  // initialize output sample
-        }
-        out[n][i] += h2mMatrix->mat[n * m_size + m] * in[m][i];
-      }
-    }
-  }
+  if (sparse)
+    IAMF_element_renderer_render_sparse(sparse, in, out, n_size, nsamples);
+  else
+    IAMF_element_renderer_render_matrix(h2mMatrix->mat, 1, m_size, in, m_size,
+                                        out, n_size, nsamples);
 
-  n = 0;
   if (lfe1 >= 0 || lfe2 >= 0) {
-    // find a channel place to move
-    for (i = 0; i < n_size; i++) {
-      if (lfe1 == i) {
-        n++;
-      }
-      if (lfe2 == i) {
-        n++;
-      }
-      map[i] = n;
-      n++;
-    }
-
     // move a channel to a new channel place
     for (i = n_size - 1; i >= 0; i--) {
-      if (map[i] != i) {
-        for (j = 0; j < nsamples; j++) {
-          out[map[i]][j] = out[i][j];
-        }
-      }
+      n = IAMF_element_renderer_get_H2M_channel(h2mMatrix, i);
+      if (n != i) memcpy(out[n], out[i], sizeof(float) * nsamples);
     }
 
-#if DISABLE_LFE_HOA == 1
-    //////////////
-    // generate lfe signal to lfe channel place
-    if (lfe1 >= 0) {
-      for (j = 0; j < nsamples; j++) {
-        out[lfe1][j] = 0;
-      }
-    }
-    //////////////
-    if (lfe2 >= 0) {
-      for (j = 0; j < nsamples; j++) {
-        out[lfe2][j] = 0;
-      }
-    }
-#else
-    //////////////
     // generate lfe signal to lfe channel place
-    if (lfe1 >= 0) {
-      for (j = 0; j < nsamples; j++) {
-        if (lfe) {  // compute lfe
-          float output;
-          output = lfefilter_update(lfe, in[0][j]);  // use W
-          if (n_size <= 2)
-            out[lfe1][j] = output * 0.5;
-          else
-            out[lfe1][j] = output / sqrt(n_size);
-        }
-        else {  // lfe off
-          out[lfe1][j] = 0;
-        }
-      }
-    }
-    //////////////
-    if (lfe2 >= 0) {
-      for (j = 0; j < nsamples; j++) {
-        if (lfe) {          // lfe on
-          if (lfe1 >= 0) {  // already compute lfe
-            out[lfe2][j] = out[lfe1][j];
-          }
-          else {  // compute lfe
-            float output;
-            output = lfefilter_update(lfe, in[0][j]);  // use W
-            if (n_size <= 2)
-              out[lfe2][j] = output * 0.5;
-            else
-              out[lfe2][j] = output / sqrt(n_size);
-          }
-        }
-        else {  // lfe off
-          out[lfe2][j] = 0;
-        }
-      }
-    }
-#endif
+    IAMF_element_renderer_render_H2M_lfe(h2mMatrix, in,
+                                         out[lfe1 >= 0 ? lfe1 : lfe2],
+                                         nsamples, lfe);
+    if (lfe1 >= 0 && lfe2 >= 0)
+      memcpy(out[lfe2], out[lfe1], sizeof(float) * nsamples);
   }
 
   return (0);
 }
 
+int IAMF_element_renderer_get_H2M_channel(struct h2m_rdr_t *h2mMatrix,
+                                          int n) {
+  int ch = n;
+
+  for (int i = 0; i <= n; i++) {
+    if (h2mMatrix->lfe1 == i) ch++;
+    if (h2mMatrix->lfe2 == i) ch++;
+  }
+  return ch;
+}
+
+void IAMF_element_renderer_render_H2M_lfe(struct h2m_rdr_t *h2mMatrix,
+                                          float *in[], float *out,
+                                          int nsamples, lfe_filter_t *lfe) {
+#if DISABLE_LFE_HOA == 0
+  int n_size = h2mMatrix->n;
+
+  if (lfe) {  // compute lfe
+    for (int j = 0; j < nsamples; j++) {
+      float output;
+      output = lfefilter_update(lfe, in[0][j]);  // use W
+      if (n_size <= 2)
+        out[j] = output * 0.5;
+      else
+        out[j] = output / sqrt(n_size);
+    }
+    return;
+  }
+#endif
+  // lfe off
+  memset(out, 0, sizeof(float) * nsamples);
+}
+
 #if DISABLE_LFE_HOA == 0
 //**cb_im
 void lfefilter_init(lfe_filter_t *lfe_f, float cutoff_freq, float sample_rate) {
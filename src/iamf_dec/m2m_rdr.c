@@ -31,6 +31,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * @version 0.1
  * @date Created 03/03/2023
  **/
+#include <stdlib.h>
+#include <string.h>
+
 #include "ae_rdr.h"
 
 #ifdef SAMSUNG_TV
@@ -1626,7 +1629,7 @@ float iamf312_mono[][1] = {{0.5}, {0.5}, {0.70710678}, {0.0}, {0.5}, {0.5}};
 
 #endif
 
-struct m2m_rdr_t m2m_rdr_tab[] = {
+static const struct m2m_rdr_t m2m_rdr_tab[] = {
     {IAMF_MONO, BS2051_A, (float *)mono_bs020, 1, 2},
     {IAMF_MONO, BS2051_B, (float *)mono_bs050, 1, 6},
     {IAMF_MONO, BS2051_C, (float *)mono_bs250, 1, 8},
@@ -1816,25 +1819,119 @@ int IAMF_element_renderer_get_M2M_custom_matrix(
   return (-1);
 }
 
-// Multichannel to Multichannel Renderer
-int IAMF_element_renderer_render_M2M(struct m2m_rdr_t *m2mMatrix, float *in[],
-                                     float *out[], int nsamples) {
-  int i, m, n;
-  int m_size = m2mMatrix->m;
-  int n_size = m2mMatrix->n;
+// the number of samples per block, the outputs of a block stay in cache.
+#define RDR_BLOCK_SIZE 256
+
+/**
+ * Every output channel is accumulated contiguously by the inputs with non
+ * zero coefficients, in the order of inputs, so the loops are vectorized and
+ * the sums are the same as the ones of the sample by sample loop.
+ * */
+void IAMF_element_renderer_render_matrix(const float *mat, int mstride,
+                                         int nstride, float *in[], int m_size,
+                                         float *out[], int n_size,
+                                         int nsamples) {
+  for (int b = 0; b < nsamples; b += RDR_BLOCK_SIZE) {
+    int size = nsamples - b < RDR_BLOCK_SIZE ? nsamples - b : RDR_BLOCK_SIZE;
+
+    for (int n = 0; n < n_size; n++) {
+      float *o = out[n] + b;
 
-  for (i = 0; i < nsamples; i++) {
-    for (m = 0; m < m_size; m++)  // input
-    {
-      for (n = 0; n < n_size; n++)  // output
-      {
-        if (m == 0) {
-          out[n][i] = 0;
-        }
-        out[n][i] += m2mMatrix->mat[m * n_size + n] * in[m][i];
+      memset(o, 0, sizeof(float) * size);
+      for (int m = 0; m < m_size; m++) {
+        const float *x = in[m] + b;
+        float c = mat[m * mstride + n * nstride];
+
+        if (c == 0.0f) continue;
+        for (int i = 0; i < size; i++) o[i] += c * x[i];
       }
     }
   }
+}
 
+/**
+ * Compiles the matrix to the list of the inputs with non zero coefficients
+ * per output, it is done once when the layouts are known.
+ * */
+struct rdr_sparse_t *IAMF_element_renderer_sparse_open(const float *mat,
+                                                       int mstride,
+                                                       int nstride, int m_size,
+                                                       int n_size) {
+  struct rdr_sparse_t *sparse;
+  int count = 0;
+
+  sparse = (struct rdr_sparse_t *)malloc(sizeof(struct rdr_sparse_t) +
+                                         sizeof(int) * (n_size + 1) +
+                                         sizeof(struct rdr_tap_t) * m_size *
+                                             n_size);
+  if (!sparse) return 0;
+
+  sparse->taps = (struct rdr_tap_t *)(sparse + 1);
+  sparse->offsets = (int *)(sparse->taps + m_size * n_size);
+  for (int n = 0; n < n_size; n++) {
+    sparse->offsets[n] = count;
+    for (int m = 0; m < m_size; m++) {
+      float c = mat[m * mstride + n * nstride];
+      if (c == 0.0f) continue;
+      sparse->taps[count].input = m;
+      sparse->taps[count].gain = c;
+      count++;
+    }
+  }
+  sparse->offsets[n_size] = count;
+
+  return sparse;
+}
+
+void IAMF_element_renderer_sparse_close(struct rdr_sparse_t *sparse) {
+  free(sparse);
+}
+
+/**
+ * The outputs without taps are silent, the ones of a single unit tap are
+ * copied, and the others are accumulated in the order of the inputs.
+ * */
+void IAMF_element_renderer_render_sparse_channel(struct rdr_sparse_t *sparse,
+                                                 float *in[], int n, float *o,
+                                                 int nsamples) {
+  struct rdr_tap_t *tap = &sparse->taps[sparse->offsets[n]];
+  int count = sparse->offsets[n + 1] - sparse->offsets[n];
+
+  if (!count) {
+    memset(o, 0, sizeof(float) * nsamples);
+  } else if (count == 1 && tap->gain == 1.0f) {
+    memcpy(o, in[tap->input], sizeof(float) * nsamples);
+  } else {
+    const float *x = in[tap->input];
+    float c = tap->gain;
+
+    for (int i = 0; i < nsamples; i++) o[i] = c * x[i];
+    for (int k = 1; k < count; k++) {
+      x = in[tap[k].input];
+      c = tap[k].gain;
+      for (int i = 0; i < nsamples; i++) o[i] += c * x[i];
+    }
+  }
+}
+
+void IAMF_element_renderer_render_sparse(struct rdr_sparse_t *sparse,
+                                         float *in[], float *out[], int n_size,
+                                         int nsamples) {
+  for (int n = 0; n < n_size; n++)
+    IAMF_element_renderer_render_sparse_channel(sparse, in, n, out[n],
+                                                nsamples);
+}
+
+// Multichannel to Multichannel Renderer
+int IAMF_element_renderer_render_M2M(struct m2m_rdr_t *m2mMatrix,
+                                     struct rdr_sparse_t *sparse, float *in[],
+                                     float *out[], int nsamples) {
+  if (sparse)
+    IAMF_element_renderer_render_sparse(sparse, in, out, m2mMatrix->n,
+                                        nsamples);
+  else
+    IAMF_element_renderer_render_matrix(m2mMatrix->mat, m2mMatrix->n, 1, in,
+                                        m2mMatrix->m, out, m2mMatrix->n,
+                                        nsamples);
   return (0);
 }
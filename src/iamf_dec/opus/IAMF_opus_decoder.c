@@ -48,11 +48,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 typedef struct IAMF_OPUS_Context {
   void *dec;
-  short *out;
 } IAMF_OPUS_Context;
 
-static int iamf_opus_close(IAMF_CodecContext *ths);
-
 /**
  *  IAC-OPUS Specific
  *
@@ -106,13 +103,6 @@ static int iamf_opus_init(IAMF_CodecContext *ths) {
     ec = IAMF_ERR_INVALID_STATE;
   }
 
-  ctx->out = (short *)malloc(sizeof(short) * MAX_OPUS_FRAME_SIZE *
-                             (ths->streams + ths->coupled_streams));
-  if (!ctx->out) {
-    iamf_opus_close(ths);
-    return IAMF_ERR_ALLOC_FAIL;
-  }
-
   return ec;
 }
 
@@ -121,23 +111,14 @@ static int iamf_opus_decode(IAMF_CodecContext *ths, uint8_t *buf[],
                             const uint32_t frame_size) {
   IAMF_OPUS_Context *ctx = (IAMF_OPUS_Context *)ths->priv;
   OpusMS2Decoder *dec = (OpusMS2Decoder *)ctx->dec;
-  int ret = IAMF_OK;
 
   if (count != ths->streams) {
     return IAMF_ERR_BAD_ARG;
   }
-  ret = opus_multistream2_decode(dec, buf, len, ctx->out, frame_size);
-  if (ret > 0) {
-    float *out = (float *)pcm;
-    uint32_t samples = ret * (ths->streams + ths->coupled_streams);
-    for (int i = 0; i < samples; ++i) {
-      out[i] = ctx->out[i] / 32768.f;
-    }
-  }
-  return ret;
+  return opus_multistream2_decode(dec, buf, len, pcm, frame_size, ths->pool);
 }
 
-int iamf_opus_close(IAMF_CodecContext *ths) {
+static int iamf_opus_close(IAMF_CodecContext *ths) {
   IAMF_OPUS_Context *ctx = (IAMF_OPUS_Context *)ths->priv;
   OpusMS2Decoder *dec = (OpusMS2Decoder *)ctx->dec;
 
@@ -145,10 +126,6 @@ int iamf_opus_close(IAMF_CodecContext *ths) {
     opus_multistream2_decoder_destroy(dec);
     ctx->dec = 0;
   }
-
-  if (ctx->out) {
-    free(ctx->out);
-  }
   return IAMF_OK;
 }
 
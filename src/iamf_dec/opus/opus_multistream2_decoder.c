@@ -41,6 +41,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IAMF_debug.h"
 #include "IAMF_defines.h"
 #include "IAMF_types.h"
+#include "IAMF_utils.h"
 #include "opus/opus.h"
 
 #ifdef IA_TAG
@@ -49,7 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IA_TAG "OPUSMS2"
 
-typedef void (*opus_copy_channels_out_func)(void *dst, const short *src,
+typedef void (*opus_copy_channels_out_func)(void *dst, const float *src,
                                             int frame_size, int channels);
 
 struct OpusMS2Decoder {
@@ -58,7 +59,13 @@ struct OpusMS2Decoder {
   int streams;
   int coupled_streams;
 
-  void *buffer;
+  float *buffers;
+  int *results;
+
+  uint8_t **packets;
+  opus_int32 *sizes;
+  float *pcm;
+  int frame_size;
 };
 
 static inline int align(int i) {
@@ -117,61 +124,95 @@ static int opus_multistream2_decoder_init(OpusMS2Decoder *st, opus_int32 Fs,
     ptr += align(mono_size);
   }
 
-  st->buffer = calloc(1, MAX_OPUS_FRAME_SIZE * 2 * sizeof(short));
-  if (!st->buffer) return IAMF_ERR_ALLOC_FAIL;
+  st->results = IAMF_MALLOCZ(int, st->streams);
+  if (!st->results) return IAMF_ERR_ALLOC_FAIL;
+
+  if (st->coupled_streams) {
+    st->buffers = IAMF_MALLOCZ(float, MAX_OPUS_FRAME_SIZE * 2 *
+                                          st->coupled_streams);
+    if (!st->buffers) return IAMF_ERR_ALLOC_FAIL;
+  }
   return IAMF_OK;
 }
 
+static OpusDecoder *opus_multistream2_decoder_get(OpusMS2Decoder *st,
+                                                   int s) {
+  char *ptr = (char *)st + align(sizeof(OpusMS2Decoder));
+
+  if (s < st->coupled_streams)
+    return (OpusDecoder *)(ptr + s * align(opus_decoder_get_size(2)));
+  ptr += st->coupled_streams * align(opus_decoder_get_size(2));
+  return (OpusDecoder *)(ptr + (s - st->coupled_streams) *
+                                   align(opus_decoder_get_size(1)));
+}
+
+/* decodes one substream, the mono substreams are decoded into their planes. */
+static void opus_multistream2_decode_task(void *arg, int s) {
+  OpusMS2Decoder *st = (OpusMS2Decoder *)arg;
+  float *out;
+
+  if (s < st->coupled_streams)
+    out = st->buffers + s * MAX_OPUS_FRAME_SIZE * 2;
+  else
+    out = st->pcm + (st->coupled_streams + s) * st->frame_size;
+
+  st->results[s] =
+      opus_decode_float(opus_multistream2_decoder_get(st, s), st->packets[s],
+                        st->sizes[s], out, st->frame_size, 0);
+  ia_logt("stream %d decoded result %d", s, st->results[s]);
+}
+
 static int opus_multistream2_decoder_decode_native(
     OpusMS2Decoder *st, uint8_t *buffer[], opus_int32 size[], void *pcm,
-    int frame_size, opus_copy_channels_out_func copy_channel_out) {
-  int coupled_size;
-  int mono_size;
+    int frame_size, ThreadPool *pool,
+    opus_copy_channels_out_func copy_channel_out) {
   int s, ret = 0;
-  char *ptr;
-  char *p = (char *)pcm;
+  float *p = (float *)pcm;
+  float *in;
 
   if (frame_size <= 0) {
     return IAMF_ERR_BAD_ARG;
   }
 
-  ptr = (char *)st + align(sizeof(OpusMS2Decoder));
-  coupled_size = opus_decoder_get_size(2);
-  mono_size = opus_decoder_get_size(1);
+  st->packets = buffer;
+  st->sizes = size;
+  st->pcm = (float *)pcm;
+  st->frame_size = frame_size;
+  thread_pool_run(pool, opus_multistream2_decode_task, st, st->streams);
 
   for (s = 0; s < st->streams; s++) {
-    OpusDecoder *dec;
-
-    dec = (OpusDecoder *)ptr;
-    ptr += (s < st->coupled_streams) ? align(coupled_size) : align(mono_size);
-
-    ret = opus_decode(dec, buffer[s], size[s], st->buffer, frame_size, 0);
-
-    ia_logt("stream %d decoded result %d", s, ret);
-    if (ret <= 0) {
-      return ret;
+    if (st->results[s] <= 0) {
+      return st->results[s];
+    }
+    if (!s) {
+      ret = st->results[s];
+    } else if (st->results[s] != ret) {
+      ia_loge("stream %d decoded %d samples, not %d.", s, st->results[s], ret);
+      return IAMF_ERR_INTERNAL;
     }
-    frame_size = ret;
+
     if (s < st->coupled_streams) {
-      (*copy_channel_out)((void *)p, st->buffer, ret, 2);
-      p += (4 * ret);
+      in = st->buffers + s * MAX_OPUS_FRAME_SIZE * 2;
+      (*copy_channel_out)((void *)p, in, ret, 2);
+      p += 2 * ret;
     } else {
-      (*copy_channel_out)((void *)p, st->buffer, ret, 1);
-      p += (2 * ret);
+      in = st->pcm + (st->coupled_streams + s) * frame_size;
+      if (in != p) memmove(p, in, sizeof(float) * ret);
+      p += ret;
     }
   }
 
   return ret;
 }
 
-void opus_copy_channel_out_short_plane(void *dst, const short *src,
+void opus_copy_channel_out_float_plane(void *dst, const float *src,
                                        int frame_size, int channels) {
   ia_logt("copy frame %d, channels %d  dst %p src %p.", frame_size, channels,
           dst, src);
   if (channels == 1) {
-    memcpy(dst, src, sizeof(short) * frame_size);
+    memcpy(dst, src, sizeof(float) * frame_size);
   } else if (channels == 2) {
-    short *pcm = (short *)dst;
+    float *pcm = (float *)dst;
     for (int s = 0; s < frame_size; ++s) {
       pcm[s] = src[channels * s];
       pcm[s + frame_size] = src[channels * s + 1];
@@ -208,25 +249,25 @@ OpusMS2Decoder *opus_multistream2_decoder_create(int Fs, int streams,
     *error = ret;
   }
   if (ret != IAMF_OK) {
-    free(st);
+    opus_multistream2_decoder_destroy(st);
     st = NULL;
   }
   return st;
 }
 
 int opus_multistream2_decode(OpusMS2Decoder *st, uint8_t *buffer[],
-                             uint32_t size[], void *pcm, uint32_t frame_size) {
+                             uint32_t size[], void *pcm, uint32_t frame_size,
+                             ThreadPool *pool) {
   if (st->flags & AUDIO_FRAME_PLANE)
     return opus_multistream2_decoder_decode_native(
-        st, buffer, (opus_int32 *)size, pcm, frame_size,
-        opus_copy_channel_out_short_plane);
+        st, buffer, (opus_int32 *)size, pcm, frame_size, pool,
+        opus_copy_channel_out_float_plane);
   ia_logw("flag is 0x%x, is not implmented.", st->flags);
   return IAMF_ERR_UNIMPLEMENTED;
 }
 
 void opus_multistream2_decoder_destroy(OpusMS2Decoder *st) {
-  if (st->buffer) {
-    free(st->buffer);
-  }
+  IAMF_FREE(st->buffers);
+  IAMF_FREE(st->results);
   free(st);
 }
@@ -37,6 +37,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 
+#include "thread_pool.h"
+
 typedef struct OpusMS2Decoder OpusMS2Decoder;
 
 OpusMS2Decoder *opus_multistream2_decoder_create(int Fs, int streams,
@@ -44,7 +46,8 @@ OpusMS2Decoder *opus_multistream2_decoder_create(int Fs, int streams,
                                                  uint32_t flags, int *error);
 
 int opus_multistream2_decode(OpusMS2Decoder *st, uint8_t *buffer[],
-                             uint32_t len[], void *pcm, uint32_t frame_size);
+                             uint32_t len[], void *pcm, uint32_t frame_size,
+                             ThreadPool *pool);
 
 void opus_multistream2_decoder_destroy(OpusMS2Decoder *st);
 
@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IAMF_debug.h"
 #include "IAMF_types.h"
 #include "bitstream.h"
+#include "sample_convert.h"
 
 #ifdef IA_TAG
 #undef IA_TAG
@@ -43,10 +44,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IA_TAG "IAMF_PCM"
 
-typedef int (*readf)(uint8_t *, int);
 typedef struct IAMF_PCM_Context {
-  float scale_i2f;
-  readf func;
+  pcm2plane_func coupled;
+  pcm2plane_func mono;
 } IAMF_PCM_Context;
 
 static int iamf_pcm_init(IAMF_CodecContext *ths) {
@@ -64,25 +64,13 @@ static int iamf_pcm_init(IAMF_CodecContext *ths) {
   ia_logd("sample format flags 0x%x, size %u, rate %u", ths->flags,
           ths->sample_size, ths->sample_rate);
 
-  ctx->func = reads16le;
-  ctx->scale_i2f = 1 << 15;
-  if (ths->sample_size == 16) {
-    if (!ths->flags) ctx->func = reads16be;
-  } else if (ths->sample_size == 24) {
-    ctx->scale_i2f = 1 << 23;
-    if (!ths->flags)
-      ctx->func = reads24be;
-    else
-      ctx->func = reads24le;
-  } else if (ths->sample_size == 32) {
-    ctx->scale_i2f = 1U << 31;
-    if (!ths->flags)
-      ctx->func = reads32be;
-    else
-      ctx->func = reads32le;
+  ctx->coupled = sample_convert_pcm2plane_get(ths->sample_size, ths->flags, 2);
+  ctx->mono = sample_convert_pcm2plane_get(ths->sample_size, ths->flags, 1);
+  if (!ctx->coupled || !ctx->mono) {
+    ia_loge("Unsupported sample size %u.", ths->sample_size);
+    return IAMF_ERR_UNIMPLEMENTED;
   }
 
-  ia_logd("the scale of int to float: %f", ctx->scale_i2f);
   return IAMF_OK;
 }
 
@@ -130,23 +118,12 @@ static int iamf_pcm_decode(IAMF_CodecContext *ths, uint8_t *buf[],
             frame_size);
 
   c = 0;
-  for (; c < ths->coupled_streams; ++c) {
-    for (int s = 0; s < samples; ++s) {
-      for (int lf = 0; lf < 2; ++lf) {
-        fpcm[samples * (c * 2 + lf) + s] =
-            ctx->func(buf[c], (s * 2 + lf) * sample_size_bytes) /
-            ctx->scale_i2f;
-      }
-    }
-  }
+  for (; c < ths->coupled_streams; ++c)
+    ctx->coupled(fpcm + samples * c * 2, buf[c], samples);
 
   cc = ths->coupled_streams;
-  for (; c < ths->streams; ++c) {
-    for (int s = 0; s < samples; ++s) {
-      fpcm[samples * (cc + c) + s] =
-          ctx->func(buf[c], s * sample_size_bytes) / ctx->scale_i2f;
-    }
-  }
+  for (; c < ths->streams; ++c)
+    ctx->mono(fpcm + samples * (cc + c), buf[c], samples);
   return samples;
 }
 
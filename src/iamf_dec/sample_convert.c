@@ -0,0 +1,630 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @file sample_convert.c
+ * @brief Sample format conversion.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#include "sample_convert.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SC_X86 1
+#define SC_TARGET(x) __attribute__((target(x)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SC_X86 1
+#define SC_TARGET(x)
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SC_NEON 1
+#include <arm_neon.h>
+#endif
+
+// the number of samples converted into the block buffer at a time.
+#define SC_BLOCK_SIZE 256
+
+typedef void (*float2int_func)(int32_t *dst, const float *src, int n,
+                               float scale, float min, float max);
+
+static void float2int_c(int32_t *dst, const float *src, int n, float scale,
+                        float min, float max) {
+  for (int i = 0; i < n; ++i) {
+    float x = src[i] * scale;
+    x = x > min ? x : min;
+    x = x < max ? x : max;
+    dst[i] = (int32_t)lrintf(x);
+  }
+}
+
+/**
+ * The vector conversions round to the nearest even as lrintf does with the
+ * default rounding mode, and the clamping returns min for NaN, so the output
+ * is the same as the one of float2int_c.
+ * */
+#if SC_X86
+SC_TARGET("sse2")
+static void float2int_sse2(int32_t *dst, const float *src, int n, float scale,
+                           float min, float max) {
+  __m128 s = _mm_set1_ps(scale);
+  __m128 lo = _mm_set1_ps(min);
+  __m128 hi = _mm_set1_ps(max);
+  int i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(src + i), s);
+    x = _mm_min_ps(_mm_max_ps(x, lo), hi);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_cvtps_epi32(x));
+  }
+  float2int_c(dst + i, src + i, n - i, scale, min, max);
+}
+
+SC_TARGET("avx2")
+static void float2int_avx2(int32_t *dst, const float *src, int n, float scale,
+                           float min, float max) {
+  __m256 s = _mm256_set1_ps(scale);
+  __m256 lo = _mm256_set1_ps(min);
+  __m256 hi = _mm256_set1_ps(max);
+  int i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 x = _mm256_mul_ps(_mm256_loadu_ps(src + i), s);
+    x = _mm256_min_ps(_mm256_max_ps(x, lo), hi);
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_cvtps_epi32(x));
+  }
+  float2int_c(dst + i, src + i, n - i, scale, min, max);
+}
+
+static int cpu_has_avx2(void) {
+#if defined(_MSC_VER)
+  int info[4];
+
+  __cpuid(info, 0);
+  if (info[0] < 7) return 0;
+  __cpuid(info, 1);
+  // OSXSAVE and AVX, then the OS saves the YMM registers.
+  if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6) return 0;
+  __cpuidex(info, 7, 0);
+  return !!(info[1] & 0x20);
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static int cpu_has_sse2(void) {
+#if defined(_MSC_VER)
+  int info[4];
+
+  __cpuid(info, 1);
+  return !!(info[3] & 0x4000000);
+#else
+  return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static int cpu_has_ssse3(void) {
+#if defined(_MSC_VER)
+  int info[4];
+
+  __cpuid(info, 1);
+  return !!(info[2] & 0x200);
+#else
+  return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+#if SC_NEON
+static void float2int_neon(int32_t *dst, const float *src, int n, float scale,
+                           float min, float max) {
+  float32x4_t s = vdupq_n_f32(scale);
+  float32x4_t lo = vdupq_n_f32(min);
+  float32x4_t hi = vdupq_n_f32(max);
+  int i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t x = vmulq_f32(vld1q_f32(src + i), s);
+    x = vminnmq_f32(vmaxnmq_f32(x, lo), hi);
+    vst1q_s32(dst + i, vcvtnq_s32_f32(x));
+  }
+  float2int_c(dst + i, src + i, n - i, scale, min, max);
+}
+#endif
+
+typedef void (*s16toplane_func)(float *dst, const int16_t *src, int n,
+                                int channels, int stride);
+
+// the planes of dst are stride samples apart.
+static void s16toplane_c(float *dst, const int16_t *src, int n, int channels,
+                         int stride) {
+  for (int c = 0; c < channels; ++c, dst += stride) {
+    for (int i = 0; i < n; ++i) dst[i] = src[channels * i + c] * (1.f / 32768);
+  }
+}
+
+#if SC_X86
+SC_TARGET("sse2")
+static void s16toplane_sse2(float *dst, const int16_t *src, int n,
+                            int channels, int stride) {
+  __m128 s = _mm_set1_ps(1.f / 32768);
+  int i = 0;
+
+  if (channels == 1) {
+    for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+      _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+      _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+    }
+  } else if (channels == 2) {
+    for (; i + 4 <= n; i += 4) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+      __m128i l = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+      __m128i r = _mm_srai_epi32(v, 16);
+      _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(l), s));
+      _mm_storeu_ps(dst + stride + i, _mm_mul_ps(_mm_cvtepi32_ps(r), s));
+    }
+  }
+  s16toplane_c(dst + i, src + channels * i, n - i, channels, stride);
+}
+#endif
+
+#if SC_NEON
+static void s16toplane_neon(float *dst, const int16_t *src, int n,
+                            int channels, int stride) {
+  float32x4_t s = vdupq_n_f32(1.f / 32768);
+  int i = 0;
+
+  if (channels == 1) {
+    for (; i + 8 <= n; i += 8) {
+      int16x8_t v = vld1q_s16(src + i);
+      int32x4_t lo = vmovl_s16(vget_low_s16(v));
+      int32x4_t hi = vmovl_s16(vget_high_s16(v));
+      vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(lo), s));
+      vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(hi), s));
+    }
+  } else if (channels == 2) {
+    for (; i + 4 <= n; i += 4) {
+      int16x4x2_t v = vld2_s16(src + 2 * i);
+      vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(v.val[0])), s));
+      vst1q_f32(dst + stride + i,
+                vmulq_f32(vcvtq_f32_s32(vmovl_s16(v.val[1])), s));
+    }
+  }
+  s16toplane_c(dst + i, src + channels * i, n - i, channels, stride);
+}
+#endif
+
+typedef void (*int2float_func)(float *dst, const int32_t *src, int n,
+                               float scale);
+
+static void int2float_c(float *dst, const int32_t *src, int n, float scale) {
+  for (int i = 0; i < n; ++i) dst[i] = src[i] * scale;
+}
+
+#if SC_X86
+SC_TARGET("sse2")
+static void int2float_sse2(float *dst, const int32_t *src, int n,
+                           float scale) {
+  __m128 s = _mm_set1_ps(scale);
+  int i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), s));
+  }
+  int2float_c(dst + i, src + i, n - i, scale);
+}
+
+SC_TARGET("avx2")
+static void int2float_avx2(float *dst, const int32_t *src, int n,
+                           float scale) {
+  __m256 s = _mm256_set1_ps(scale);
+  int i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+  }
+  int2float_c(dst + i, src + i, n - i, scale);
+}
+#endif
+
+#if SC_NEON
+static void int2float_neon(float *dst, const int32_t *src, int n,
+                           float scale) {
+  float32x4_t s = vdupq_n_f32(scale);
+  int i = 0;
+
+  for (; i + 4 <= n; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), s));
+  int2float_c(dst + i, src + i, n - i, scale);
+}
+#endif
+
+static int2float_func int2float_select(void) {
+#if SC_X86
+  if (cpu_has_avx2()) return int2float_avx2;
+  if (cpu_has_sse2()) return int2float_sse2;
+#elif SC_NEON
+  return int2float_neon;
+#endif
+  return int2float_c;
+}
+
+static s16toplane_func s16toplane_select(void) {
+#if SC_X86
+  if (cpu_has_sse2()) return s16toplane_sse2;
+#elif SC_NEON
+  return s16toplane_neon;
+#endif
+  return s16toplane_c;
+}
+
+static float2int_func float2int_select(void) {
+#if SC_X86
+  if (cpu_has_avx2()) return float2int_avx2;
+  if (cpu_has_sse2()) return float2int_sse2;
+#elif SC_NEON
+  return float2int_neon;
+#endif
+  return float2int_c;
+}
+
+static int2float_func sc_int2float;
+static s16toplane_func sc_s16toplane;
+static float2int_func sc_float2int;
+
+static int2float_func int2float_get(void) {
+  if (!sc_int2float) sc_int2float = int2float_select();
+  return sc_int2float;
+}
+
+static s16toplane_func s16toplane_get(void) {
+  if (!sc_s16toplane) sc_s16toplane = s16toplane_select();
+  return sc_s16toplane;
+}
+
+static float2int_func float2int_get(void) {
+  if (!sc_float2int) sc_float2int = float2int_select();
+  return sc_float2int;
+}
+
+static inline int32_t pcm_read(const uint8_t *p, int bytes, int le) {
+  uint32_t v;
+
+  if (bytes == 2) {
+    v = le ? p[0] | p[1] << 8 : p[0] << 8 | p[1];
+    return (int16_t)v;
+  } else if (bytes == 3) {
+    v = le ? p[0] | p[1] << 8 | (uint32_t)p[2] << 16
+           : (uint32_t)p[0] << 16 | p[1] << 8 | p[2];
+    return (int32_t)(v << 8) >> 8;
+  }
+  v = le ? p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24
+         : (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+  return (int32_t)v;
+}
+
+/**
+ * Deinterleave n frames of 1 or 2 channels into the planes of dst, which are
+ * stride samples apart. The arguments are constant in the specialized
+ * kernels, so the branches are resolved at compile time.
+ * */
+static inline void pcm2plane_c(float *dst, const uint8_t *src, int n,
+                               int channels, int stride, int bytes, int le) {
+  float scale = 1.f / (1u << (bytes * 8 - 1));
+
+  for (int c = 0; c < channels; ++c, dst += stride) {
+    const uint8_t *p = src + bytes * c;
+    for (int i = 0; i < n; ++i, p += bytes * channels)
+      dst[i] = pcm_read(p, bytes, le) * scale;
+  }
+}
+
+/**
+ * The shuffle moves the bytes of 4 samples into the high bytes of 32 bits
+ * lanes, the low bytes are zero (index 0x80), then the lanes are shifted
+ * right arithmetically to sign extend the samples.
+ * */
+static void pcm2plane_mask(uint8_t *mask, int bytes, int le) {
+  for (int k = 0; k < 4; ++k) {
+    for (int j = 0; j < 4; ++j) {
+      int b = j - (4 - bytes);
+      mask[k * 4 + j] = b < 0 ? 0x80 : k * bytes + (le ? b : bytes - 1 - b);
+    }
+  }
+}
+
+#if SC_X86
+SC_TARGET("ssse3")
+static inline void pcm2plane_ssse3(float *dst, const uint8_t *src, int n,
+                                   int channels, int stride, int bytes,
+                                   int le) {
+  uint8_t m[16];
+  __m128i mask, shift;
+  __m128 s = _mm_set1_ps(1.f / (1u << (bytes * 8 - 1)));
+  int total = n * channels;
+  int k = 0;
+
+  pcm2plane_mask(m, bytes, le);
+  mask = _mm_loadu_si128((const __m128i *)m);
+  shift = _mm_cvtsi32_si128(32 - bytes * 8);
+
+  // 8 samples at a time, the second load reads 16 bytes from sample 4.
+  for (; (k + 4) * bytes + 16 <= total * bytes; k += 8) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(src + k * bytes));
+    __m128i b = _mm_loadu_si128((const __m128i *)(src + (k + 4) * bytes));
+    __m128 fa, fb;
+
+    a = _mm_sra_epi32(_mm_shuffle_epi8(a, mask), shift);
+    b = _mm_sra_epi32(_mm_shuffle_epi8(b, mask), shift);
+    fa = _mm_mul_ps(_mm_cvtepi32_ps(a), s);
+    fb = _mm_mul_ps(_mm_cvtepi32_ps(b), s);
+    if (channels == 1) {
+      _mm_storeu_ps(dst + k, fa);
+      _mm_storeu_ps(dst + k + 4, fb);
+    } else {
+      _mm_storeu_ps(dst + k / 2, _mm_shuffle_ps(fa, fb, 0x88));
+      _mm_storeu_ps(dst + stride + k / 2, _mm_shuffle_ps(fa, fb, 0xdd));
+    }
+  }
+  k /= channels;
+  pcm2plane_c(dst + k, src + k * channels * bytes, n - k, channels, stride,
+              bytes, le);
+}
+#endif
+
+#if SC_NEON
+static inline void pcm2plane_neon(float *dst, const uint8_t *src, int n,
+                                  int channels, int stride, int bytes,
+                                  int le) {
+  uint8_t m[16];
+  uint8x16_t mask;
+  int32x4_t shift = vdupq_n_s32(bytes * 8 - 32);
+  float32x4_t s = vdupq_n_f32(1.f / (1u << (bytes * 8 - 1)));
+  int total = n * channels;
+  int k = 0;
+
+  pcm2plane_mask(m, bytes, le);
+  mask = vld1q_u8(m);
+
+  for (; (k + 4) * bytes + 16 <= total * bytes; k += 8) {
+    uint8x16_t a = vqtbl1q_u8(vld1q_u8(src + k * bytes), mask);
+    uint8x16_t b = vqtbl1q_u8(vld1q_u8(src + (k + 4) * bytes), mask);
+    float32x4_t fa = vmulq_f32(
+        vcvtq_f32_s32(vshlq_s32(vreinterpretq_s32_u8(a), shift)), s);
+    float32x4_t fb = vmulq_f32(
+        vcvtq_f32_s32(vshlq_s32(vreinterpretq_s32_u8(b), shift)), s);
+    if (channels == 1) {
+      vst1q_f32(dst + k, fa);
+      vst1q_f32(dst + k + 4, fb);
+    } else {
+      float32x4x2_t lr = vuzpq_f32(fa, fb);
+      vst1q_f32(dst + k / 2, lr.val[0]);
+      vst1q_f32(dst + stride + k / 2, lr.val[1]);
+    }
+  }
+  k /= channels;
+  pcm2plane_c(dst + k, src + k * channels * bytes, n - k, channels, stride,
+              bytes, le);
+}
+#endif
+
+#define PCM2PLANE_KERNEL(isa, name, channels, bytes, le)                       \
+  static void pcm2plane_##name##_##isa(float *dst, const uint8_t *src,         \
+                                       int frame_size) {                       \
+    pcm2plane_##isa(dst, src, frame_size, channels, frame_size, bytes,         \
+                    le);                                                       \
+  }
+
+#define PCM2PLANE_KERNELS(isa)                                                 \
+  PCM2PLANE_KERNEL(isa, s16be_mono, 1, 2, 0)                                   \
+  PCM2PLANE_KERNEL(isa, s16be_stereo, 2, 2, 0)                                 \
+  PCM2PLANE_KERNEL(isa, s16le_mono, 1, 2, 1)                                   \
+  PCM2PLANE_KERNEL(isa, s16le_stereo, 2, 2, 1)                                 \
+  PCM2PLANE_KERNEL(isa, s24be_mono, 1, 3, 0)                                   \
+  PCM2PLANE_KERNEL(isa, s24be_stereo, 2, 3, 0)                                 \
+  PCM2PLANE_KERNEL(isa, s24le_mono, 1, 3, 1)                                   \
+  PCM2PLANE_KERNEL(isa, s24le_stereo, 2, 3, 1)                                 \
+  PCM2PLANE_KERNEL(isa, s32be_mono, 1, 4, 0)                                   \
+  PCM2PLANE_KERNEL(isa, s32be_stereo, 2, 4, 0)                                 \
+  PCM2PLANE_KERNEL(isa, s32le_mono, 1, 4, 1)                                   \
+  PCM2PLANE_KERNEL(isa, s32le_stereo, 2, 4, 1)                                 \
+  static const pcm2plane_func pcm2plane_##isa##_kernels[3][2][2] = {           \
+      {{pcm2plane_s16be_mono_##isa, pcm2plane_s16be_stereo_##isa},             \
+       {pcm2plane_s16le_mono_##isa, pcm2plane_s16le_stereo_##isa}},            \
+      {{pcm2plane_s24be_mono_##isa, pcm2plane_s24be_stereo_##isa},             \
+       {pcm2plane_s24le_mono_##isa, pcm2plane_s24le_stereo_##isa}},            \
+      {{pcm2plane_s32be_mono_##isa, pcm2plane_s32be_stereo_##isa},             \
+       {pcm2plane_s32le_mono_##isa, pcm2plane_s32le_stereo_##isa}}};
+
+PCM2PLANE_KERNELS(c)
+#if SC_X86
+#undef PCM2PLANE_KERNEL
+#define PCM2PLANE_KERNEL(isa, name, channels, bytes, le)                       \
+  SC_TARGET("ssse3")                                                           \
+  static void pcm2plane_##name##_##isa(float *dst, const uint8_t *src,         \
+                                       int frame_size) {                       \
+    pcm2plane_##isa(dst, src, frame_size, channels, frame_size, bytes,         \
+                    le);                                                       \
+  }
+PCM2PLANE_KERNELS(ssse3)
+#elif SC_NEON
+PCM2PLANE_KERNELS(neon)
+#endif
+
+typedef const pcm2plane_func (*pcm2plane_table)[2][2];
+
+static pcm2plane_table pcm2plane_select(void) {
+#if SC_X86
+  if (cpu_has_ssse3()) return pcm2plane_ssse3_kernels;
+#elif SC_NEON
+  return pcm2plane_neon_kernels;
+#endif
+  return pcm2plane_c_kernels;
+}
+
+static pcm2plane_table sc_pcm2plane;
+
+static pcm2plane_table pcm2plane_get(void) {
+  if (!sc_pcm2plane) sc_pcm2plane = pcm2plane_select();
+  return sc_pcm2plane;
+}
+
+void sample_convert_init(void) {
+  int2float_get();
+  s16toplane_get();
+  float2int_get();
+  pcm2plane_get();
+}
+
+void sample_convert_plane2stride(void *dst, const float *src, int frame_size,
+                                 int channels, uint32_t bit_depth,
+                                 uint32_t stride) {
+  float2int_func float2int = float2int_get();
+  int32_t block[SC_BLOCK_SIZE];
+  int bytes = bit_depth / 8;
+  float scale, min, max;
+  int c, i, n;
+
+  if (bytes < 2 || bytes > 4 || frame_size <= 0) return;
+
+  if (!src || channels <= 0) {
+    memset(dst, 0, (size_t)bytes * frame_size * stride);
+    return;
+  }
+
+  if (bit_depth == 16) {
+    scale = 32768.f;
+    min = -32768.f;
+    max = 32767.f;
+  } else if (bit_depth == 24) {
+    scale = 8388608.f;
+    min = -8388608.f;
+    max = 8388607.f;
+  } else {
+    scale = 2147483648.f;
+    min = -2147483648.f;
+    max = 2147483647.f;
+  }
+
+  if (stride > (uint32_t)channels) {
+    uint8_t *p = (uint8_t *)dst + bytes * channels;
+    int size = bytes * (stride - channels);
+    for (i = 0; i < frame_size; ++i, p += bytes * stride) memset(p, 0, size);
+  }
+
+  for (int off = 0; off < frame_size; off += SC_BLOCK_SIZE) {
+    n = frame_size - off;
+    if (n > SC_BLOCK_SIZE) n = SC_BLOCK_SIZE;
+
+    for (c = 0; c < channels; ++c) {
+      float2int(block, src + frame_size * c + off, n, scale, min, max);
+      if (bytes == 2) {
+        int16_t *p = (int16_t *)dst + off * stride + c;
+        for (i = 0; i < n; ++i, p += stride) *p = (int16_t)block[i];
+      } else if (bytes == 3) {
+        uint8_t *p = (uint8_t *)dst + (off * stride + c) * 3;
+        for (i = 0; i < n; ++i, p += stride * 3) {
+          p[0] = block[i] & 0xff;
+          p[1] = (block[i] >> 8) & 0xff;
+          p[2] = ((block[i] >> 16) & 0x7f) | ((block[i] >> 24) & 0x80);
+        }
+      } else {
+        int32_t *p = (int32_t *)dst + off * stride + c;
+        for (i = 0; i < n; ++i, p += stride) *p = block[i];
+      }
+    }
+  }
+}
+
+void sample_convert_plane2stride_float(float *dst, const float *src,
+                                       int frame_size, int channels) {
+  if (!src) {
+    memset(dst, 0, sizeof(float) * frame_size * channels);
+  } else if (channels == 1) {
+    memcpy(dst, src, sizeof(float) * frame_size);
+  } else if (channels == 2) {
+    const float *l = src, *r = src + frame_size;
+    for (int i = 0; i < frame_size; ++i) {
+      dst[2 * i] = l[i];
+      dst[2 * i + 1] = r[i];
+    }
+  } else {
+    for (int i = 0; i < frame_size; ++i, dst += channels) {
+      for (int c = 0; c < channels; ++c) dst[c] = src[frame_size * c + i];
+    }
+  }
+}
+
+void sample_convert_stride2plane_float(float *dst, const float *src,
+                                       int frame_size, int channels) {
+  if (!src) {
+    memset(dst, 0, sizeof(float) * frame_size * channels);
+  } else if (channels == 1) {
+    memcpy(dst, src, sizeof(float) * frame_size);
+  } else if (channels == 2) {
+    float *l = dst, *r = dst + frame_size;
+    for (int i = 0; i < frame_size; ++i) {
+      l[i] = src[2 * i];
+      r[i] = src[2 * i + 1];
+    }
+  } else {
+    for (int c = 0; c < channels; ++c, dst += frame_size) {
+      for (int i = 0; i < frame_size; ++i) dst[i] = src[channels * i + c];
+    }
+  }
+}
+
+void sample_convert_stride2plane_s16(float *dst, const int16_t *src,
+                                     int frame_size, int channels) {
+  if (frame_size <= 0 || channels <= 0) return;
+  s16toplane_get()(dst, src, frame_size, channels, frame_size);
+}
+
+void sample_convert_int2float(float *dst, const int32_t *src, int n,
+                              float scale) {
+  if (n > 0) int2float_get()(dst, src, n, scale);
+}
+
+pcm2plane_func sample_convert_pcm2plane_get(uint32_t bit_depth, int le,
+                                            int channels) {
+  int f = bit_depth / 8 - 2;
+
+  if (bit_depth % 8 || f < 0 || f > 2 || channels < 1 || channels > 2)
+    return 0;
+  return pcm2plane_get()[f][!!le][channels - 1];
+}
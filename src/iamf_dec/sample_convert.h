@@ -0,0 +1,107 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @file sample_convert.h
+ * @brief Sample format conversion APIs.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#ifndef SAMPLE_CONVERT_H
+#define SAMPLE_CONVERT_H
+
+#include <stdint.h>
+
+/**
+ * @brief     Select the conversion kernels for the running CPU. The kernels
+ *            are selected by the first conversion otherwise, so call it
+ *            before converting in several threads at the same time.
+ */
+void sample_convert_init(void);
+
+/**
+ * @brief     Convert planar float samples to interleaved integer samples, the
+ *            samples are clamped and rounded to the nearest.
+ * @param     [out] dst : the interleaved samples, the channels from channels
+ *                        to stride are filled with zero.
+ * @param     [in] src : the planar samples, or null to output silence.
+ * @param     [in] frame_size : the number of samples per channel.
+ * @param     [in] channels : the number of channels.
+ * @param     [in] bit_depth : 16, 24 (packed) or 32.
+ * @param     [in] stride : the number of channels per interleaved sample.
+ */
+void sample_convert_plane2stride(void *dst, const float *src, int frame_size,
+                                 int channels, uint32_t bit_depth,
+                                 uint32_t stride);
+
+/**
+ * @brief     Interleave planar float samples.
+ */
+void sample_convert_plane2stride_float(float *dst, const float *src,
+                                       int frame_size, int channels);
+
+/**
+ * @brief     Deinterleave float samples.
+ */
+void sample_convert_stride2plane_float(float *dst, const float *src,
+                                       int frame_size, int channels);
+
+/**
+ * @brief     Deinterleave 16 bits integer samples into planar float samples,
+ *            the samples are scaled into [-1, 1).
+ */
+void sample_convert_stride2plane_s16(float *dst, const int16_t *src,
+                                     int frame_size, int channels);
+
+/**
+ * @brief     Convert 32 bits integer samples to float samples multiplied by
+ *            scale.
+ */
+void sample_convert_int2float(float *dst, const int32_t *src, int n,
+                              float scale);
+
+/**
+ * @brief     Deinterleave and convert the LPCM samples of 1 or 2 channels to
+ *            planar float samples in [-1, 1), the planes are frame_size
+ *            samples apart.
+ */
+typedef void (*pcm2plane_func)(float *dst, const uint8_t *src,
+                               int frame_size);
+
+/**
+ * @brief     Get the kernel of the LPCM format.
+ * @param     [in] bit_depth : 16, 24 or 32.
+ * @param     [in] le : little endian or not.
+ * @param     [in] channels : 1 or 2.
+ * @return    the kernel, or 0 if the format is not supported.
+ */
+pcm2plane_func sample_convert_pcm2plane_get(uint32_t bit_depth, int le,
+                                            int channels);
+
+#endif /* SAMPLE_CONVERT_H */
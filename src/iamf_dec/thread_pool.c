@@ -0,0 +1,245 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @file thread_pool.c
+ * @brief Thread pool.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#include "thread_pool.h"
+
+#include "IAMF_debug.h"
+#include "IAMF_utils.h"
+
+#ifdef IA_TAG
+#undef IA_TAG
+#endif
+
+#define IA_TAG "IAMF_TP"
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef HANDLE tp_thread_t;
+typedef CRITICAL_SECTION tp_mutex_t;
+typedef CONDITION_VARIABLE tp_cond_t;
+#define TP_THREAD_FUNC DWORD WINAPI
+
+#define tp_mutex_init(m) InitializeCriticalSection(m)
+#define tp_mutex_destroy(m) DeleteCriticalSection(m)
+#define tp_mutex_lock(m) EnterCriticalSection(m)
+#define tp_mutex_unlock(m) LeaveCriticalSection(m)
+#define tp_cond_init(c) InitializeConditionVariable(c)
+#define tp_cond_destroy(c)
+#define tp_cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define tp_cond_broadcast(c) WakeAllConditionVariable(c)
+
+static int tp_thread_create(tp_thread_t *t, LPTHREAD_START_ROUTINE func,
+                            void *arg) {
+  *t = CreateThread(NULL, 0, func, arg, 0, NULL);
+  return *t ? 0 : -1;
+}
+
+static void tp_thread_join(tp_thread_t t) {
+  WaitForSingleObject(t, INFINITE);
+  CloseHandle(t);
+}
+#else
+#include <pthread.h>
+
+typedef pthread_t tp_thread_t;
+typedef pthread_mutex_t tp_mutex_t;
+typedef pthread_cond_t tp_cond_t;
+#define TP_THREAD_FUNC void *
+
+#define tp_mutex_init(m) pthread_mutex_init(m, 0)
+#define tp_mutex_destroy(m) pthread_mutex_destroy(m)
+#define tp_mutex_lock(m) pthread_mutex_lock(m)
+#define tp_mutex_unlock(m) pthread_mutex_unlock(m)
+#define tp_cond_init(c) pthread_cond_init(c, 0)
+#define tp_cond_destroy(c) pthread_cond_destroy(c)
+#define tp_cond_wait(c, m) pthread_cond_wait(c, m)
+#define tp_cond_broadcast(c) pthread_cond_broadcast(c)
+
+static int tp_thread_create(tp_thread_t *t, void *(*func)(void *),
+                            void *arg) {
+  return pthread_create(t, 0, func, arg);
+}
+
+static void tp_thread_join(tp_thread_t t) { pthread_join(t, 0); }
+#endif
+
+#define THREAD_POOL_MAX_THREADS 64
+
+typedef struct TaskBatch {
+  thread_task_func func;
+  void *arg;
+  int count;
+  int next;
+  int done;
+  struct TaskBatch *link;
+} TaskBatch;
+
+struct ThreadPool {
+  int threads;
+  int nb_workers;
+  tp_thread_t *workers;
+
+  tp_mutex_t lock;
+  tp_cond_t work;
+  tp_cond_t finish;
+  TaskBatch *batches;
+  int exit;
+};
+
+static TaskBatch *thread_pool_get_pending_batch(ThreadPool *pool) {
+  for (TaskBatch *b = pool->batches; b; b = b->link)
+    if (b->next < b->count) return b;
+  return 0;
+}
+
+/* must be called with the lock held, the lock is held again on return. */
+static void thread_pool_execute_task(ThreadPool *pool, TaskBatch *b) {
+  int i = b->next++;
+
+  tp_mutex_unlock(&pool->lock);
+  b->func(b->arg, i);
+  tp_mutex_lock(&pool->lock);
+
+  if (++b->done == b->count) tp_cond_broadcast(&pool->finish);
+}
+
+static TP_THREAD_FUNC thread_pool_worker(void *arg) {
+  ThreadPool *pool = (ThreadPool *)arg;
+  TaskBatch *b;
+
+  tp_mutex_lock(&pool->lock);
+  while (1) {
+    b = thread_pool_get_pending_batch(pool);
+    if (b) {
+      thread_pool_execute_task(pool, b);
+    } else if (pool->exit) {
+      break;
+    } else {
+      tp_cond_wait(&pool->work, &pool->lock);
+    }
+  }
+  tp_mutex_unlock(&pool->lock);
+
+  return 0;
+}
+
+ThreadPool *thread_pool_open(int threads) {
+  ThreadPool *pool;
+
+  if (threads < 2) return 0;
+  if (threads > THREAD_POOL_MAX_THREADS) threads = THREAD_POOL_MAX_THREADS;
+
+  pool = IAMF_MALLOCZ(ThreadPool, 1);
+  if (!pool) return 0;
+
+  pool->workers = IAMF_MALLOCZ(tp_thread_t, threads - 1);
+  if (!pool->workers) {
+    free(pool);
+    return 0;
+  }
+
+  tp_mutex_init(&pool->lock);
+  tp_cond_init(&pool->work);
+  tp_cond_init(&pool->finish);
+
+  for (int i = 0; i < threads - 1; ++i) {
+    if (tp_thread_create(&pool->workers[i], thread_pool_worker, pool)) {
+      ia_logw("only %d worker threads are created.", i);
+      break;
+    }
+    ++pool->nb_workers;
+  }
+
+  if (!pool->nb_workers) {
+    thread_pool_close(pool);
+    return 0;
+  }
+
+  pool->threads = pool->nb_workers + 1;
+  ia_logd("thread pool with %d threads.", pool->threads);
+
+  return pool;
+}
+
+void thread_pool_close(ThreadPool *pool) {
+  if (!pool) return;
+
+  tp_mutex_lock(&pool->lock);
+  pool->exit = 1;
+  tp_cond_broadcast(&pool->work);
+  tp_mutex_unlock(&pool->lock);
+
+  for (int i = 0; i < pool->nb_workers; ++i) tp_thread_join(pool->workers[i]);
+
+  tp_cond_destroy(&pool->finish);
+  tp_cond_destroy(&pool->work);
+  tp_mutex_destroy(&pool->lock);
+  free(pool->workers);
+  free(pool);
+}
+
+int thread_pool_get_threads(ThreadPool *pool) {
+  return pool ? pool->threads : 1;
+}
+
+void thread_pool_run(ThreadPool *pool, thread_task_func func, void *arg,
+                     int count) {
+  TaskBatch b;
+  TaskBatch **p;
+
+  if (!pool || count < 2) {
+    for (int i = 0; i < count; ++i) func(arg, i);
+    return;
+  }
+
+  b.func = func;
+  b.arg = arg;
+  b.count = count;
+  b.next = b.done = 0;
+
+  tp_mutex_lock(&pool->lock);
+  b.link = pool->batches;
+  pool->batches = &b;
+  tp_cond_broadcast(&pool->work);
+
+  while (b.next < b.count) thread_pool_execute_task(pool, &b);
+  while (b.done < b.count) tp_cond_wait(&pool->finish, &pool->lock);
+
+  for (p = &pool->batches; *p != &b; p = &(*p)->link)
+    ;
+  *p = b.link;
+  tp_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,74 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @file thread_pool.h
+ * @brief Thread pool APIs.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+typedef void (*thread_task_func)(void *arg, int index);
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * @brief     Open a thread pool.
+ * @param     [in] threads : the number of threads which decode concurrently,
+ *                           the calling thread is included.
+ * @return    the thread pool handle, or 0 if threads is less than 2 or the
+ *            platform has no thread support.
+ */
+ThreadPool *thread_pool_open(int threads);
+
+/**
+ * @brief     Close a thread pool, the worker threads are joined.
+ */
+void thread_pool_close(ThreadPool *pool);
+
+/**
+ * @brief     Get the number of threads, the calling thread is included.
+ */
+int thread_pool_get_threads(ThreadPool *pool);
+
+/**
+ * @brief     Run func on arg for each index in [0, count) and return after all
+ *            of the tasks are done. The calling thread executes tasks too, so
+ *            the function can be called from a task of the same pool. If pool
+ *            is 0, the tasks are executed in order on the calling thread.
+ * @param     [in] pool : the thread pool.
+ * @param     [in] func : the task function.
+ * @param     [in] arg : the argument shared by the tasks.
+ * @param     [in] count : the number of tasks.
+ */
+void thread_pool_run(ThreadPool *pool, thread_task_func func, void *arg,
+                     int count);
+
+#endif /* THREAD_POOL_H */
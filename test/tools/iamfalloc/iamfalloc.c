@@ -0,0 +1,232 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file iamfalloc.c
+ * @brief Check that IAMF_decoder_decode does not allocate memory.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "IAMF_decoder.h"
+
+#ifndef __GLIBC__
+#error "iamfalloc interposes the glibc allocator."
+#endif
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+extern void __libc_free(void *p);
+
+static int counting = 0;
+static unsigned long allocs = 0;
+static unsigned long frees = 0;
+static unsigned long first_allocs = 0;
+
+static void count_alloc(void) {
+  if (__atomic_load_n(&counting, __ATOMIC_RELAXED))
+    __atomic_fetch_add(&allocs, 1, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+  count_alloc();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+  count_alloc();
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+  count_alloc();
+  return __libc_realloc(p, size);
+}
+
+void free(void *p) {
+  if (p && __atomic_load_n(&counting, __ATOMIC_RELAXED))
+    __atomic_fetch_add(&frees, 1, __ATOMIC_RELAXED);
+  __libc_free(p);
+}
+
+static void print_usage(char *argv[]) {
+  fprintf(stderr, "Usage:\n");
+  fprintf(stderr, "%s <options> <input file>\n", argv[0]);
+  fprintf(stderr, "options:\n");
+  fprintf(stderr, "-s[0~12,b]  : output layout, the sound system A~J, "
+                  "extensions (7.1.2, 3.1.2, mono) and binaural "
+                  "(default 2).\n");
+  fprintf(stderr, "-d          : bit depth of pcm output (default 16).\n");
+  fprintf(stderr, "-r          : sampling rate of pcm output.\n");
+  fprintf(stderr, "-t          : number of decoding threads.\n");
+  fprintf(stderr, "-p          : enable pipelined decoding.\n");
+  fprintf(stderr, "The input is an IAMF bitstream with a single "
+                  "configuration, the tool fails if any sample is decoded "
+                  "with memory allocation after the first frame. The "
+                  "allocations of the first frame are reported only, "
+                  "libFLAC allocates its frame buffers then.\n");
+}
+
+static uint8_t *read_file(const char *path, uint32_t *size) {
+  FILE *f = fopen(path, "rb");
+  uint8_t *buf = 0;
+  long len;
+
+  if (!f) return 0;
+  fseek(f, 0L, SEEK_END);
+  len = ftell(f);
+  fseek(f, 0L, SEEK_SET);
+  if (len > 0) buf = (uint8_t *)malloc(len);
+  if (buf && fread(buf, 1, len, f) != (size_t)len) {
+    free(buf);
+    buf = 0;
+  }
+  fclose(f);
+  *size = buf ? (uint32_t)len : 0;
+  return buf;
+}
+
+int main(int argc, char *argv[]) {
+  IAMF_DecoderHandle dec = 0;
+  IAMF_StreamInfo *info;
+  const char *path = 0;
+  uint8_t *buf = 0;
+  void *pcm = 0;
+  uint32_t size = 0, used = 0, rsize = 0;
+  int ss = 2, binaural = 0, bit_depth = 16, rate = 0, threads = 0;
+  int pipeline = 0;
+  int channels, frames = 0, calls = 0;
+  unsigned long samples = 0;
+  int ret = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] != '-') {
+      path = argv[i];
+    } else if (argv[i][1] == 's') {
+      if (argv[i][2] == 'b')
+        binaural = 1;
+      else
+        ss = atoi(argv[i] + 2);
+    } else if (argv[i][1] == 'd') {
+      bit_depth = atoi(argv[i] + 2);
+    } else if (argv[i][1] == 'r') {
+      rate = atoi(argv[i] + 2);
+    } else if (argv[i][1] == 't') {
+      threads = atoi(argv[i] + 2);
+    } else if (argv[i][1] == 'p') {
+      pipeline = 1;
+    } else {
+      print_usage(argv);
+      return 1;
+    }
+  }
+
+  if (!path) {
+    print_usage(argv);
+    return 1;
+  }
+
+  buf = read_file(path, &size);
+  if (!buf) {
+    fprintf(stderr, "fail to read %s.\n", path);
+    return 1;
+  }
+
+  dec = IAMF_decoder_open();
+  if (!dec) goto end;
+  if (binaural) {
+    IAMF_decoder_output_layout_set_binaural(dec);
+    channels = IAMF_layout_binaural_channels_count();
+  } else {
+    IAMF_decoder_output_layout_set_sound_system(dec, (IAMF_SoundSystem)ss);
+    channels = IAMF_layout_sound_system_channels_count((IAMF_SoundSystem)ss);
+  }
+  IAMF_decoder_set_bit_depth(dec, bit_depth);
+  if (rate > 0) IAMF_decoder_set_sampling_rate(dec, rate);
+  if (threads > 1) IAMF_decoder_set_threads(dec, threads);
+  if (pipeline) IAMF_decoder_pipeline_enable(dec, 1);
+
+  ret = IAMF_decoder_configure(dec, buf, size, &rsize);
+  if (ret != IAMF_OK) {
+    fprintf(stderr, "errno: %d, fail to configure decoder.\n", ret);
+    ret = 1;
+    goto end;
+  }
+  used = rsize;
+
+  info = IAMF_decoder_get_stream_info(dec);
+  pcm = malloc((size_t)bit_depth / 8 * info->max_output_size * channels);
+  if (!pcm) goto end;
+
+  while (1) {
+    int end = used >= size;
+
+    rsize = 0;
+    __atomic_store_n(&counting, 1, __ATOMIC_RELAXED);
+    if (!end)
+      ret = IAMF_decoder_decode(dec, buf + used, size - used, &rsize, pcm);
+    else
+      ret = IAMF_decoder_decode(dec, 0, 0, &rsize, pcm);
+    __atomic_store_n(&counting, 0, __ATOMIC_RELAXED);
+    if (!calls++) {
+      first_allocs = allocs;
+      allocs = frees = 0;
+    }
+
+    if (ret < 0) {
+      fprintf(stderr, "errno: %d, fail to decode.\n", ret);
+      ret = 1;
+      goto end;
+    }
+    if (ret > 0) {
+      ++frames;
+      samples += ret;
+    }
+    if (end) break;
+    // flush when the rest is not a complete temporal unit.
+    used = rsize ? used + rsize : size;
+  }
+
+  fprintf(stdout, "decode calls %d, frames %d, samples %lu\n", calls, frames,
+          samples);
+  fprintf(stdout, "allocations %lu, frees %lu, first frame allocations %lu\n",
+          allocs, frees, first_allocs);
+  ret = allocs || frees ? 1 : 0;
+  if (ret) fprintf(stderr, "IAMF_decoder_decode allocates memory.\n");
+
+end:
+  if (dec) IAMF_decoder_close(dec);
+  if (pcm) free(pcm);
+  if (buf) free(buf);
+  return ret;
+}
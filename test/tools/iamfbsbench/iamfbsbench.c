@@ -0,0 +1,289 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file iamfbsbench.c
+ * @brief Compare the bitstream readers on the OBUs of an IAMF bitstream.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "IAMF_OBU.h"
+#include "obu_walk.h"
+
+#define OBU_GROUP_DESCRIPTOR 0
+#define OBU_GROUP_PARAMETER_BLOCK 1
+#define OBU_GROUP_COUNT 2
+#define BENCH_ROUNDS 5
+
+typedef struct {
+  int type;
+  const uint8_t *payload;
+  uint32_t size;
+} Payload;
+
+typedef struct {
+  Payload *items;
+  int count;
+} PayloadList;
+
+typedef uint32_t (*obu_walk_func)(WalkContext *, int, const uint8_t *,
+                                  uint32_t);
+
+static const char *group_names[OBU_GROUP_COUNT] = {"descriptors",
+                                                   "parameter blocks"};
+
+static void print_usage(char *argv[]) {
+  fprintf(stderr, "Usage:\n");
+  fprintf(stderr, "%s <options> <input file>\n", argv[0]);
+  fprintf(stderr, "options:\n");
+  fprintf(stderr, "-n          : iterations of each reader (default 1000).\n");
+  fprintf(stderr, "The fields of the descriptor and parameter block OBUs are "
+                  "read with the legacy reader and the 64-bit cached reader, "
+                  "the tool fails if any value differs.\n");
+}
+
+static uint8_t *read_file(const char *path, uint32_t *size) {
+  FILE *f = fopen(path, "rb");
+  uint8_t *buf = 0;
+  long len;
+
+  if (!f) return 0;
+  fseek(f, 0L, SEEK_END);
+  len = ftell(f);
+  fseek(f, 0L, SEEK_SET);
+  if (len > 0) buf = (uint8_t *)malloc(len);
+  if (buf && fread(buf, 1, len, f) != (size_t)len) {
+    free(buf);
+    buf = 0;
+  }
+  fclose(f);
+  *size = buf ? (uint32_t)len : 0;
+  return buf;
+}
+
+static uint32_t leb128(const uint8_t *p, uint32_t size, uint64_t *v) {
+  uint32_t i;
+
+  *v = 0;
+  for (i = 0; i < 8 && i < size; ++i) {
+    *v |= ((uint64_t)p[i] & 0x7f) << (i * 7);
+    if (!(p[i] & 0x80)) return i + 1;
+  }
+  return i;
+}
+
+/* collects the payloads of descriptor and parameter block OBUs by group. */
+static int split_obus(const uint8_t *data, uint32_t size,
+                      PayloadList lists[]) {
+  uint32_t pos = 0;
+
+  for (int g = 0; g < OBU_GROUP_COUNT; ++g) {
+    lists[g].items = (Payload *)calloc(size / 2 + 1, sizeof(Payload));
+    if (!lists[g].items) return -1;
+    lists[g].count = 0;
+  }
+
+  while (pos + 2 <= size) {
+    uint8_t h = data[pos];
+    int type = h >> 3;
+    uint64_t v, end, skip;
+    uint32_t p = pos + 1;
+    int g;
+
+    p += leb128(data + p, size - p, &v);
+    if (v > size - p) break;
+    end = p + v;
+    if (h & 0x2) {
+      p += leb128(data + p, (uint32_t)(end - p), &skip);
+      p += leb128(data + p, (uint32_t)(end - p), &skip);
+    }
+    if (h & 0x1) {
+      p += leb128(data + p, (uint32_t)(end - p), &skip);
+      p += skip;
+    }
+    pos = (uint32_t)end;
+    if (p > end) continue;
+
+    if (type == IAMF_OBU_PARAMETER_BLOCK)
+      g = OBU_GROUP_PARAMETER_BLOCK;
+    else if (type == IAMF_OBU_CODEC_CONFIG ||
+             type == IAMF_OBU_AUDIO_ELEMENT ||
+             type == IAMF_OBU_MIX_PRESENTATION ||
+             type == IAMF_OBU_SEQUENCE_HEADER)
+      g = OBU_GROUP_DESCRIPTOR;
+    else
+      continue;
+
+    lists[g].items[lists[g].count].type = type;
+    lists[g].items[lists[g].count].payload = data + p;
+    lists[g].items[lists[g].count].size = (uint32_t)(end - p);
+    ++lists[g].count;
+  }
+
+  return 0;
+}
+
+static void walk_list(obu_walk_func walk, WalkContext *ctx,
+                      PayloadList *list) {
+  for (int i = 0; i < list->count; ++i)
+    walk(ctx, list->items[i].type, list->items[i].payload,
+         list->items[i].size);
+}
+
+/**
+ * Drops the obus whose fields run past the payload, the legacy reader reads
+ * the following bytes there while the cached one reads zero.
+ * */
+static int drop_overruns(WalkContext *ctx, PayloadList *list) {
+  uint32_t size = ctx->size;
+  int count = 0;
+
+  ctx->size = 0;
+  for (int i = 0; i < list->count; ++i) {
+    Payload *item = &list->items[i];
+    if (obu_walk(ctx, item->type, item->payload, item->size) <= item->size)
+      list->items[count++] = *item;
+  }
+  ctx->size = size;
+  count = list->count - count;
+  list->count -= count;
+  return count;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench(obu_walk_func walk, WalkContext *ctx, PayloadList *list,
+                    int iterations) {
+  double start = now();
+
+  for (int n = 0; n < iterations; ++n) {
+    ctx->count = 0;
+    walk_list(walk, ctx, list);
+  }
+  return now() - start;
+}
+
+int main(int argc, char *argv[]) {
+  static WalkContext ctxs[2];
+  obu_walk_func walks[2] = {obu_walk_legacy, obu_walk};
+  PayloadList lists[OBU_GROUP_COUNT] = {0};
+  const char *path = 0;
+  uint8_t *buf = 0;
+  uint32_t size = 0, count = 0;
+  int iterations = 1000;
+  int ret = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] != '-') {
+      path = argv[i];
+    } else if (argv[i][1] == 'n') {
+      iterations = atoi(argv[i] + 2);
+    } else {
+      print_usage(argv);
+      return 1;
+    }
+  }
+
+  if (!path || iterations <= 0) {
+    print_usage(argv);
+    return 1;
+  }
+
+  buf = read_file(path, &size);
+  if (!buf) {
+    fprintf(stderr, "fail to read %s.\n", path);
+    return 1;
+  }
+
+  if (split_obus(buf, size, lists) < 0) goto end;
+
+  // every byte is a field at most, and bs_tell is recorded per obu.
+  for (int r = 0; r < 2; ++r) {
+    ctxs[r].size = size * 2;
+    ctxs[r].values = (uint64_t *)calloc(ctxs[r].size, sizeof(uint64_t));
+    if (!ctxs[r].values) goto end;
+  }
+
+  // the parameter blocks are read with the definitions in the descriptors.
+  for (int g = 0; g < OBU_GROUP_COUNT; ++g) {
+    int dropped = drop_overruns(&ctxs[1], &lists[g]);
+    if (dropped)
+      fprintf(stderr, "skip %d %s which overrun the payload.\n", dropped,
+              group_names[g]);
+
+    for (int r = 0; r < 2; ++r) {
+      ctxs[r].count = 0;
+      walk_list(walks[r], &ctxs[r], &lists[g]);
+    }
+    if (ctxs[0].count != ctxs[1].count || ctxs[0].count > ctxs[0].size ||
+        memcmp(ctxs[0].values, ctxs[1].values,
+               sizeof(uint64_t) * ctxs[0].count)) {
+      fprintf(stderr, "the values of %s differ.\n", group_names[g]);
+      goto end;
+    }
+    count += ctxs[0].count;
+
+    // the best of the rounds, the readers take turns to share the noise.
+    double times[2] = {0};
+    for (int n = 0; n < BENCH_ROUNDS; ++n) {
+      for (int r = 0; r < 2; ++r) {
+        double t = bench(walks[r], &ctxs[r], &lists[g], iterations);
+        if (!n || t < times[r]) times[r] = t;
+      }
+    }
+    double legacy = times[0], cached = times[1];
+    double fields = (double)ctxs[0].count * iterations;
+
+    fprintf(stdout,
+            "%s: obus %d, fields %u, legacy %.3f ms (%.2f ns/field), cached "
+            "%.3f ms (%.2f ns/field), speedup %.2fx\n",
+            group_names[g], lists[g].count, ctxs[0].count, legacy * 1e3,
+            fields ? legacy * 1e9 / fields : 0, cached * 1e3,
+            fields ? cached * 1e9 / fields : 0,
+            cached > 0 ? legacy / cached : 0);
+  }
+
+  ret = count ? 0 : 1;
+  if (ret) fprintf(stderr, "no descriptor or parameter block is found.\n");
+
+end:
+  for (int r = 0; r < 2; ++r) free(ctxs[r].values);
+  for (int g = 0; g < OBU_GROUP_COUNT; ++g) free(lists[g].items);
+  free(buf);
+  return ret;
+}
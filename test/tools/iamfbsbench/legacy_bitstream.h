@@ -0,0 +1,79 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file legacy_bitstream.h
+ * @brief The bitstream reader before the 64-bit cache, kept to compare with.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#ifndef LEGACY_BIT_STREAM_H
+#define LEGACY_BIT_STREAM_H
+
+#include <stdint.h>
+
+/* the legacy names, so both readers can be linked into one program. */
+#define BitStream LegacyBitStream
+#define bs legacy_bs
+#define bs_get32b legacy_bs_get32b
+#define bs_skip legacy_bs_skip
+#define bs_align legacy_bs_align
+#define bs_skipABytes legacy_bs_skipABytes
+#define bs_getA8b legacy_bs_getA8b
+#define bs_getA16b legacy_bs_getA16b
+#define bs_getA32b legacy_bs_getA32b
+#define bs_getAleb128 legacy_bs_getAleb128
+#define bs_read legacy_bs_read
+#define bs_readString legacy_bs_readString
+#define bs_tell legacy_bs_tell
+
+#define INT8_BITS 8
+#define INT16_BITS 16
+#define INT32_BITS 32
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t size;
+  uint32_t b8sp;  // bytes, less than size;
+  uint32_t b8p;   // 0~7
+} BitStream;
+
+int32_t bs(BitStream *b, const uint8_t *data, int size);
+uint32_t bs_get32b(BitStream *b, int n);
+int32_t bs_skip(BitStream *b, int n);
+void bs_align(BitStream *b);
+int32_t bs_skipABytes(BitStream *b, int n);
+uint32_t bs_getA8b(BitStream *b);
+uint32_t bs_getA16b(BitStream *b);
+uint32_t bs_getA32b(BitStream *b);
+uint64_t bs_getAleb128(BitStream *b);
+int32_t bs_read(BitStream *b, uint8_t *data, int n);
+int32_t bs_readString(BitStream *b, char *data, int n);
+uint32_t bs_tell(BitStream *b);
+
+#endif /* LEGACY_BIT_STREAM_H */
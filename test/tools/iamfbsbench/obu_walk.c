@@ -0,0 +1,323 @@
+/*
+BSD 3-Clause Clear License The Clear BSD License
+
+Copyright (c) 2023, Alliance for Open Media.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file obu_walk.c
+ * @brief Read the fields of descriptor and parameter block OBUs.
+ * @version 0.1
+ * @date Created 10/17/2026
+ **/
+
+#include "obu_walk.h"
+
+#include "IAMF_OBU.h"
+#include "IAMF_utils.h"
+
+#ifdef LEGACY_READER
+#include "legacy_bitstream.h"
+#define obu_walk obu_walk_legacy
+#else
+#include "bitstream.h"
+#endif
+
+#define STRING_SIZE 128
+#define LOUDNESS_INFO_TYPE_TRUE_PEAK 1
+#define LOUDNESS_INFO_TYPE_ANCHORED 2
+#define LOUDNESS_INFO_TYPE_ALL \
+  (LOUDNESS_INFO_TYPE_TRUE_PEAK | LOUDNESS_INFO_TYPE_ANCHORED)
+
+static inline uint64_t walk_put(WalkContext *ctx, uint64_t v) {
+  if (ctx->count < ctx->size) ctx->values[ctx->count] = v;
+  ++ctx->count;
+  return v;
+}
+
+static WalkParameter *walk_parameter_find(WalkContext *ctx, uint64_t id) {
+  for (int i = 0; i < ctx->nb_parameters; ++i)
+    if (ctx->parameters[i].id == id) return &ctx->parameters[i];
+  return 0;
+}
+
+static WalkParameter *walk_parameter_add(WalkContext *ctx, uint64_t id) {
+  WalkParameter *p = walk_parameter_find(ctx, id);
+  if (p) return p;
+  if (ctx->nb_parameters == WALK_PARAMETERS_MAX) return 0;
+  return &ctx->parameters[ctx->nb_parameters++];
+}
+
+static WalkParameter *walk_parameter_base(WalkContext *ctx, BitStream *b,
+                                          uint64_t type) {
+  WalkParameter *p;
+  uint64_t id, duration, interval;
+  uint32_t mode;
+
+  id = walk_put(ctx, bs_getAleb128(b));
+  walk_put(ctx, bs_getAleb128(b));
+  mode = walk_put(ctx, bs_get32b(b, 1));
+
+  p = walk_parameter_add(ctx, id);
+  if (!p) return 0;
+  p->id = id;
+  p->type = type;
+  p->mode = mode;
+  p->nb_segments = 0;
+  p->nb_layers = 0;
+  p->recon_gain_present_flags = 0;
+
+  if (!mode) {
+    duration = walk_put(ctx, bs_getAleb128(b));
+    interval = walk_put(ctx, bs_getAleb128(b));
+    if (!interval) {
+      p->nb_segments = walk_put(ctx, bs_getAleb128(b));
+      for (uint64_t i = 0; i < p->nb_segments; ++i)
+        walk_put(ctx, bs_getAleb128(b));
+    } else {
+      p->nb_segments = (duration + interval - 1) / interval;
+    }
+  }
+
+  return p;
+}
+
+static void walk_element(WalkContext *ctx, BitStream *b) {
+  uint8_t mapping[STRING_SIZE * 8];
+  WalkParameter *recon = 0;
+  uint32_t type, val, n, streams;
+  uint64_t ptype, size;
+
+  walk_put(ctx, bs_getAleb128(b));
+  type = walk_put(ctx, bs_get32b(b, 3));
+  bs_get32b(b, 5);
+  walk_put(ctx, bs_getAleb128(b));
+
+  val = walk_put(ctx, bs_getAleb128(b));
+  for (uint32_t i = 0; i < val; ++i) walk_put(ctx, bs_getAleb128(b));
+
+  val = walk_put(ctx, bs_getAleb128(b));
+  for (uint32_t i = 0; i < val; ++i) {
+    ptype = walk_put(ctx, bs_getAleb128(b));
+    if (ptype == IAMF_PARAMETER_TYPE_DEMIXING) {
+      walk_parameter_base(ctx, b, ptype);
+      walk_put(ctx, bs_get32b(b, 3));
+      bs_skip(b, 5);
+      walk_put(ctx, bs_get32b(b, 4));
+      bs_skip(b, 4);
+    } else if (ptype == IAMF_PARAMETER_TYPE_RECON_GAIN) {
+      recon = walk_parameter_base(ctx, b, ptype);
+    } else {
+      size = walk_put(ctx, bs_getAleb128(b));
+      bs_skipABytes(b, size);
+    }
+  }
+
+  if (type == AUDIO_ELEMENT_TYPE_CHANNEL_BASED) {
+    val = walk_put(ctx, bs_get32b(b, 3));
+    bs_skip(b, 5);
+    for (uint32_t i = 0; i < val; ++i) {
+      uint32_t output_gain_flag, recon_gain_flag;
+
+      walk_put(ctx, bs_get32b(b, 4));
+      output_gain_flag = walk_put(ctx, bs_get32b(b, 1));
+      recon_gain_flag = walk_put(ctx, bs_get32b(b, 1));
+      walk_put(ctx, bs_getA8b(b));
+      walk_put(ctx, bs_getA8b(b));
+      if (output_gain_flag) {
+        walk_put(ctx, bs_get32b(b, 6));
+        walk_put(ctx, bs_getA16b(b));
+      }
+      if (recon && recon_gain_flag)
+        recon->recon_gain_present_flags |= RSHIFT(i);
+    }
+    if (recon) recon->nb_layers = val;
+  } else if (type == AUDIO_ELEMENT_TYPE_SCENE_BASED) {
+    val = walk_put(ctx, bs_getAleb128(b));
+    if (val == AMBISONICS_MODE_MONO) {
+      n = walk_put(ctx, bs_getA8b(b));
+      walk_put(ctx, bs_getA8b(b));
+    } else if (val == AMBISONICS_MODE_PROJECTION) {
+      n = walk_put(ctx, bs_getA8b(b));
+      streams = walk_put(ctx, bs_getA8b(b));
+      streams += walk_put(ctx, bs_getA8b(b));
+      n *= 2 * streams;
+    } else {
+      n = 0;
+    }
+    if (n > sizeof(mapping)) n = sizeof(mapping);
+    bs_read(b, mapping, n);
+    for (uint32_t i = 0; i < n; ++i) walk_put(ctx, mapping[i]);
+  } else {
+    size = walk_put(ctx, bs_getAleb128(b));
+    bs_skipABytes(b, size);
+  }
+}
+
+static void walk_mix_presentation(WalkContext *ctx, BitStream *b) {
+  char label[STRING_SIZE];
+  uint64_t labels, val, size;
+  uint32_t info_type;
+
+  walk_put(ctx, bs_getAleb128(b));
+  labels = walk_put(ctx, bs_getAleb128(b));
+  for (uint64_t i = 0; i < labels * 2; ++i)
+    walk_put(ctx, bs_readString(b, label, STRING_SIZE));
+
+  val = walk_put(ctx, bs_getAleb128(b));
+  if (val != 1) return;
+
+  val = walk_put(ctx, bs_getAleb128(b));
+  for (uint64_t i = 0; i < val; ++i) {
+    walk_put(ctx, bs_getAleb128(b));
+    for (uint64_t k = 0; k < labels; ++k)
+      walk_put(ctx, bs_readString(b, label, STRING_SIZE));
+    walk_put(ctx, bs_get32b(b, 2));
+    size = walk_put(ctx, bs_getAleb128(b));
+    bs_skipABytes(b, size);
+    walk_parameter_base(ctx, b, IAMF_PARAMETER_TYPE_MIX_GAIN);
+    walk_put(ctx, bs_getA16b(b));
+  }
+
+  walk_parameter_base(ctx, b, IAMF_PARAMETER_TYPE_MIX_GAIN);
+  walk_put(ctx, bs_getA16b(b));
+
+  val = walk_put(ctx, bs_getAleb128(b));
+  for (uint64_t i = 0; i < val; ++i) {
+    if (walk_put(ctx, bs_get32b(b, 2)) ==
+        IAMF_LAYOUT_TYPE_LOUDSPEAKERS_SS_CONVENTION)
+      walk_put(ctx, bs_get32b(b, 4));
+    bs_align(b);
+
+    info_type = walk_put(ctx, bs_getA8b(b));
+    walk_put(ctx, bs_getA16b(b));
+    walk_put(ctx, bs_getA16b(b));
+    if (info_type & LOUDNESS_INFO_TYPE_TRUE_PEAK) walk_put(ctx, bs_getA16b(b));
+    if (info_type & LOUDNESS_INFO_TYPE_ANCHORED) {
+      uint32_t n = walk_put(ctx, bs_getA8b(b));
+      for (uint32_t k = 0; k < n; ++k) {
+        walk_put(ctx, bs_getA8b(b));
+        walk_put(ctx, bs_getA16b(b));
+      }
+    }
+    if (info_type & ~LOUDNESS_INFO_TYPE_ALL) {
+      size = walk_put(ctx, bs_getAleb128(b));
+      bs_skipABytes(b, size);
+    }
+  }
+}
+
+static void walk_parameter_block(WalkContext *ctx, BitStream *b) {
+  uint8_t gains[IA_CH_RE_COUNT];
+  WalkParameter *p;
+  uint64_t nb_segments, interval = 0;
+  uint32_t animated, flags;
+  int channels;
+
+  p = walk_parameter_find(ctx, walk_put(ctx, bs_getAleb128(b)));
+  if (!p) return;
+
+  nb_segments = p->nb_segments;
+  if (p->mode) {
+    uint64_t duration = walk_put(ctx, bs_getAleb128(b));
+    interval = walk_put(ctx, bs_getAleb128(b));
+    if (!interval)
+      nb_segments = walk_put(ctx, bs_getAleb128(b));
+    else
+      nb_segments = (duration + interval - 1) / interval;
+  }
+
+  for (uint64_t i = 0; i < nb_segments; ++i) {
+    if (p->mode && !interval) walk_put(ctx, bs_getAleb128(b));
+
+    switch (p->type) {
+      case IAMF_PARAMETER_TYPE_MIX_GAIN:
+        animated = walk_put(ctx, bs_getAleb128(b));
+        walk_put(ctx, bs_getA16b(b));
+        if (animated != PARAMETER_ANIMATED_TYPE_STEP) {
+          walk_put(ctx, bs_getA16b(b));
+          if (animated == PARAMETER_ANIMATED_TYPE_BEZIER) {
+            walk_put(ctx, bs_getA16b(b));
+            walk_put(ctx, bs_getA8b(b));
+          }
+        }
+        break;
+      case IAMF_PARAMETER_TYPE_DEMIXING:
+        walk_put(ctx, bs_get32b(b, 3));
+        break;
+      case IAMF_PARAMETER_TYPE_RECON_GAIN:
+        for (int k = 0; k < p->nb_layers; ++k) {
+          if (~p->recon_gain_present_flags & RSHIFT(k)) continue;
+          flags = walk_put(ctx, bs_getAleb128(b));
+          for (channels = 0; flags; flags &= flags - 1) ++channels;
+          if (channels > IA_CH_RE_COUNT) return;
+          bs_read(b, gains, channels);
+          for (int t = 0; t < channels; ++t) walk_put(ctx, gains[t]);
+        }
+        break;
+      default: {
+        uint64_t size = walk_put(ctx, bs_getAleb128(b));
+        bs_skipABytes(b, size);
+      } break;
+    }
+  }
+}
+
+uint32_t obu_walk(WalkContext *ctx, int type, const uint8_t *payload,
+                  uint32_t size) {
+  uint8_t code[4];
+  BitStream b;
+
+  bs(&b, payload, size);
+  switch (type) {
+    case IAMF_OBU_SEQUENCE_HEADER:
+      bs_read(&b, code, 4);
+      walk_put(ctx, code[0] | code[1] << 8 | code[2] << 16 |
+                        (uint32_t)code[3] << 24);
+      walk_put(ctx, bs_getA8b(&b));
+      walk_put(ctx, bs_getA8b(&b));
+      break;
+    case IAMF_OBU_CODEC_CONFIG:
+      walk_put(ctx, bs_getAleb128(&b));
+      bs_read(&b, code, 4);
+      walk_put(ctx, code[0] | code[1] << 8 | code[2] << 16 |
+                        (uint32_t)code[3] << 24);
+      walk_put(ctx, bs_getAleb128(&b));
+      walk_put(ctx, bs_getA16b(&b));
+      break;
+    case IAMF_OBU_AUDIO_ELEMENT:
+      walk_element(ctx, &b);
+      break;
+    case IAMF_OBU_MIX_PRESENTATION:
+      walk_mix_presentation(ctx, &b);
+      break;
+    case IAMF_OBU_PARAMETER_BLOCK:
+      walk_parameter_block(ctx, &b);
+      break;
+    default:
+      break;
+  }
+
+  return walk_put(ctx, bs_tell(&b));
+}
@@ -26,24 +26,48 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 /**
- * @file queue_t.h
- * @brief Queue APIs.
+ * @file obu_walk.h
+ * @brief Read the fields of descriptor and parameter block OBUs.
  * @version 0.1
- * @date Created 23/05/2023
+ * @date Created 10/17/2026
  **/
 
+#ifndef OBU_WALK_H
+#define OBU_WALK_H
 
-#ifndef _QUEUE_H_
-#define _QUEUE_H_
+#include <stdint.h>
 
-typedef struct _queue_t queue_t;
+#define WALK_PARAMETERS_MAX 64
 
-queue_t *queue_new();
-int queue_push(queue_t *, void *);
-void *queue_pop(queue_t *);
-void *queue_take(queue_t *, int);
-int queue_is_empty(queue_t *);
-int queue_length(queue_t *);
-void queue_free(queue_t *);
+/* the parameter definition which is needed to read the parameter blocks. */
+typedef struct {
+  uint64_t id;
+  uint64_t type;
+  uint32_t mode;
+  uint64_t nb_segments;
+  int nb_layers;
+  uint32_t recon_gain_present_flags;
+} WalkParameter;
 
-#endif /* _QUEUE_H_ */
+/**
+ * The values of the fields are appended to values, the ones beyond size are
+ * counted only.
+ * */
+typedef struct {
+  WalkParameter parameters[WALK_PARAMETERS_MAX];
+  int nb_parameters;
+  uint64_t *values;
+  uint32_t count;
+  uint32_t size;
+} WalkContext;
+
+/**
+ * Reads the payload of the obu in the same order as the decoder, with the
+ * current reader or the legacy one. Returns the position after the fields.
+ * */
+uint32_t obu_walk(WalkContext *ctx, int type, const uint8_t *payload,
+                  uint32_t size);
+uint32_t obu_walk_legacy(WalkContext *ctx, int type, const uint8_t *payload,
+                         uint32_t size);
+
+#endif /* OBU_WALK_H */
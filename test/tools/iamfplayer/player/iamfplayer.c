@@ -55,6 +55,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define FLAG_VLOG 0x2
 #endif
 #define FLAG_DISABLE_LIMITER 0x4
+#define FLAG_PIPELINE 0x8
 #define FLAG_TEST_SOUND_SYSTEM 0x100
 #define SAMPLING_RATE 48000
 
@@ -74,6 +75,7 @@ typedef struct PlayerArgs {
   uint32_t st;
   uint32_t rate;
   uint32_t bit_depth;
+  uint32_t threads;
   uint64_t mix_presentation_id;
 } PlayerArgs;
 
@@ -131,7 +133,9 @@ static void print_usage(char *argv[]) {
   fprintf(stderr, "-mp [id]     : Set mix presentation id.\n");
   fprintf(stderr,
           "-m           : Generate a metadata file with the suffix .met .\n");
+  fprintf(stderr, "-threads [n] : Number of decoding threads.\n");
   fprintf(stderr, "-disable_limiter\n             : Disable peak limiter.\n");
+  fprintf(stderr, "-pipeline    : Enable pipelined decoding.\n");
 }
 
 static uint32_t valid_sound_system_layout(uint32_t ss) {
@@ -411,6 +415,8 @@ static int player_init(Player *pr, PlayerArgs *pas) {
     IAMF_decoder_peak_limiter_set_threshold(pr->dec, pas->peak);
   IAMF_decoder_set_normalization_loudness(pr->dec, pas->loudness);
   IAMF_decoder_set_bit_depth(pr->dec, pas->bit_depth);
+  if (pas->threads > 1) IAMF_decoder_set_threads(pr->dec, pas->threads);
+  if (pas->flags & FLAG_PIPELINE) IAMF_decoder_pipeline_enable(pr->dec, 1);
 
   if (pr->rate > 0 &&
       IAMF_decoder_set_sampling_rate(pr->dec, pr->rate) != IAMF_OK) {
@@ -576,7 +582,7 @@ static int bs_input_wav_output(PlayerArgs *pas) {
         state = 1;
         IAMF_StreamInfo *info = IAMF_decoder_get_stream_info(pr.dec);
         if (!pcm)
-          pcm = (void *)malloc(pas->bit_depth / 8 * info->max_frame_size *
+          pcm = (void *)malloc(pas->bit_depth / 8 * info->max_output_size *
                                pr.channels);
       } else if (ret != IAMF_ERR_BUFFER_TOO_SMALL) {
         fprintf(stderr, "errno: %d, fail to configure decoder.\n", ret);
@@ -724,7 +730,8 @@ static int mp4_input_wav_output2(PlayerArgs *pas) {
     IAMF_decoder_set_mix_presentation_id(pr.dec, pas->mix_presentation_id);
   ret = IAMF_decoder_configure(pr.dec, block, ret, 0);
   IAMF_StreamInfo *info = IAMF_decoder_get_stream_info(pr.dec);
-  pcm = (void *)malloc(pas->bit_depth / 8 * info->max_frame_size * pr.channels);
+  pcm = (void *)malloc(pas->bit_depth / 8 * info->max_output_size *
+                       pr.channels);
   if (!pcm) {
     ret = errno;
     fprintf(stderr, "error no(%d):fail to malloc memory for pcm.", ret);
@@ -866,6 +873,9 @@ int main(int argc, char *argv[]) {
         if (!strcmp(argv[args], "-ts")) {
           pas.st = strtoul(argv[++args], NULL, 10);
           fprintf(stdout, "Start time : %us\n", pas.st);
+        } else if (!strcmp(argv[args], "-threads")) {
+          pas.threads = strtoul(argv[++args], NULL, 10);
+          fprintf(stdout, "Threads : %u\n", pas.threads);
 #ifdef SAMSUNG_TV
         } else if (!strcmp(argv[args], "-test_soundsystem")) {
           pas.flags |= FLAG_TEST_SOUND_SYSTEM;
@@ -882,6 +892,9 @@ int main(int argc, char *argv[]) {
       } else if (!strcmp(argv[args], "-disable_limiter")) {
         pas.flags |= FLAG_DISABLE_LIMITER;
         fprintf(stdout, "Disable peak limiter\n");
+      } else if (!strcmp(argv[args], "-pipeline")) {
+        pas.flags |= FLAG_PIPELINE;
+        fprintf(stdout, "Enable pipelined decoding\n");
       }
     } else {
       f = argv[args];